@@ -0,0 +1,54 @@
+/*
+  Library example to measure the time spent by TM16xxButtons::tick().
+  To measure only the button handling, the module is simulated: getButtons() returns a fixed value instead of
+  reading the chip. tick() only advances the buttons that are pressed or still being tracked (e.g. waiting for a
+  double click), so when idle it only reads the buttons and does a single compare.
+  On a real module the time to read the buttons is added (see the TM16xx_benchmark example for bus speeds).
+
+  The results are printed on the serial console.
+
+  For more information see  https://github.com/maxint-rd/TM16xx
+*/
+#include <TM1638.h>
+#include <TM16xxButtons.h>
+
+class TM1638Simulated : public TM1638
+{ // TM1638 that returns the buttons set in dwSimulated instead of reading them from the chip
+  public:
+    TM1638Simulated(byte dataPin, byte clockPin, byte strobePin) : TM1638(dataPin, clockPin, strobePin) {}
+    virtual uint32_t getButtons() { return(dwSimulated); }
+    uint32_t dwSimulated=0;
+};
+
+TM1638Simulated module(8, 9, 7);   // DIO=8, CLK=9, STB=7
+TM16xxButtons buttons(&module);
+
+#define BENCH_TICKS 10000
+
+void measure(const __FlashStringHelper *szTitle, uint32_t dwButtons)
+{
+  module.dwSimulated=dwButtons;
+  buttons.reset();
+  uint32_t tStart=micros();
+  for(uint16_t n=0; n<BENCH_TICKS; n++)
+    buttons.tick();
+  uint32_t tDuration=micros()-tStart;
+  Serial.print(szTitle);
+  Serial.print(F(": "));
+  Serial.print(BENCH_TICKS*1000000.0/tDuration, 0);
+  Serial.println(F(" ticks/sec"));
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(F("TM16xxButtons tick() benchmark"));
+}
+
+void loop()
+{
+  measure(F("no buttons pressed"), 0);
+  measure(F("one button held"), 0x01);
+  measure(F("two buttons held"), 0x81);
+  delay(2000);
+}
@@ -0,0 +1,116 @@
+/*
+  Library example to measure the gain of direct GPIO register access (TM16XX_OPT_FASTGPIO).
+  The same TM1638 module is driven by two classes that only differ in how the pins are written:
+  one calls digitalWrite() for every pin change (like the library does when TM16XX_OPT_FASTGPIO is 0),
+  the other uses TM16xxFastPin (like the library does when TM16XX_OPT_FASTGPIO is 1).
+  Both send the same frames using the same bit sequence and timing (24 pin writes per byte), so the
+  difference in speed is caused by the pin access only.
+
+  The results are printed on the serial console.
+
+  For more information see  https://github.com/maxint-rd/TM16xx
+*/
+#include <TM1638.h>
+#include <TM16xxGPIO.h>
+
+// Pin access using digitalWrite(), which looks up the port and mask of the pin on every call
+class DigitalWritePin
+{
+  public:
+    void begin(byte pin) { _pin=pin; }
+    inline void write(byte level) { digitalWrite(_pin, level); }
+  private:
+    byte _pin;
+};
+
+// TM1638 sending data using the specified pin access class. Same bit sequence as TM16xx::send().
+template <class Pin>
+class TM1638Bench : public TM1638
+{
+  public:
+    TM1638Bench(byte dataPin, byte clockPin, byte strobePin) : TM1638(dataPin, clockPin, strobePin)
+    {
+      _pinData.begin(dataPin);
+      _pinClock.begin(clockPin);
+      _pinStrobe.begin(strobePin);
+    }
+
+  protected:
+    virtual void start()
+    {
+      _pinStrobe.write(LOW);
+      bitDelay();
+    }
+
+    virtual void stop()
+    {
+      _pinStrobe.write(HIGH);
+      bitDelay();
+    }
+
+    virtual void send(byte data)
+    {
+      for(byte i=0; i<8; i++)
+      {
+        _pinClock.write(LOW);
+        bitDelay();
+        _pinData.write(data & 1 ? HIGH : LOW);
+        bitDelay();
+        data >>= 1;
+        _pinClock.write(HIGH);
+        bitDelay();
+      }
+      bitDelay();
+    }
+
+  private:
+    Pin _pinData;
+    Pin _pinClock;
+    Pin _pinStrobe;
+};
+
+// Define the TM1638 module twice, using the same pins. Pin suggestions:
+// ESP8266 (Wemos D1): data pin 5 (D1), clock pin 4 (D2), strobe pin 0 (D3)
+// Arduino Nano: data pin 8, clock pin 9, strobe pin 7
+TM1638Bench<DigitalWritePin> moduleDigitalWrite(8, 9, 7);   // DIO=8, CLK=9, STB=7
+TM1638Bench<TM16xxFastPin> moduleFastPin(8, 9, 7);
+
+#define BENCH_ROUNDS 100
+
+void runBenchmark(const __FlashStringHelper *szTitle, TM1638 &module)
+{ // send 8 digits per frame in buffered mode, each frame has different data
+  module.setBuffered(true);
+  module.resetWriteCounters();
+  uint32_t tStart=micros();
+  for(int n=0; n<BENCH_ROUNDS; n++)
+  {
+    for(byte nPos=0; nPos<8; nPos++)
+      module.setSegments(n+nPos, nPos);
+    module.flush();
+  }
+  uint32_t tDuration=micros()-tStart;
+  module.setBuffered(false);
+
+  uint32_t nBytes=module.getWritesPerformed();
+  Serial.print(szTitle);
+  Serial.print(F(": "));
+  Serial.print(tDuration/BENCH_ROUNDS);
+  Serial.print(F(" us per frame, "));
+  Serial.print(nBytes*1000000UL/tDuration);
+  Serial.println(F(" bytes/sec"));
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  moduleDigitalWrite.begin(true, 2);
+  moduleFastPin.begin(true, 2);
+  Serial.println(F("TM16xx GPIO benchmark"));
+}
+
+void loop()
+{
+  runBenchmark(F("digitalWrite()"), moduleDigitalWrite);
+  runBenchmark(F("TM16xxFastPin"), moduleFastPin);
+  delay(2000);
+}
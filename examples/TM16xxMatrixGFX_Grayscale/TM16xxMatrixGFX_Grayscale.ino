@@ -0,0 +1,40 @@
+/*
+  Library example to show 16 levels of brightness per pixel on a TM1640 8x16 matrix module.
+  In grayscale mode the matrix bitmap has four bit-planes. serviceGrayscale() shows these planes one after the
+  other, each for twice as long as the previous one. The color used for drawing is the level of the pixel (0-15).
+  Call serviceGrayscale() as often as possible, e.g. by not using delay() in loop().
+  When the display flickers, try a smaller plane time or use fewer bits.
+
+  For more information see  https://github.com/maxint-rd/TM16xx
+*/
+#include <Adafruit_GFX.h>
+#include <TM1640.h>
+#include <TM16xxMatrixGFX.h>
+
+TM1640 module(9, 10);    // DIN=9, CLK=10
+
+#define MODULE_SIZECOLUMNS 16   // number of GRD lines, will be the y-height of the display
+#define MODULE_SIZEROWS 8       // number of SEG lines, will be the x-width of the display
+TM16xxMatrixGFX matrix(&module, MODULE_SIZECOLUMNS, MODULE_SIZEROWS);    // TM16xx object, columns, rows
+
+void setup()
+{
+  Serial.begin(115200);
+  matrix.setIntensity(7);
+  if(!matrix.setGrayscale(4, 300))    // 4 bits per pixel, least significant plane is shown for 300us
+    Serial.println(F("Not enough memory for grayscale mode"));
+}
+
+void loop()
+{
+  static uint32_t tLast=0;
+  static byte nOffset=0;
+  if(millis()-tLast>100)
+  { // draw a moving gradient: each row is one level brighter than the row above
+    tLast=millis();
+    for(int16_t y=0; y<matrix.height(); y++)
+      matrix.drawFastHLine(0, y, matrix.width(), (y+nOffset)%16);
+    nOffset++;
+  }
+  matrix.serviceGrayscale();
+}
@@ -0,0 +1,54 @@
+/*
+  Library example to update multiple TM1640 matrix modules in parallel.
+  The modules share the clock line, but each module has its own data line.
+  The TM16xxParallel class sends the data of all modules in the same clock cycles, so refreshing
+  the whole matrix takes about the same time as refreshing a single module.
+  For best results put the data pins on the same GPIO port (e.g. Arduino Nano pins 2-7 are on PORTD).
+
+  For more information see  https://github.com/maxint-rd/TM16xx
+*/
+#include <Adafruit_GFX.h>
+#include <TM1640.h>
+#include <TM16xxMatrixGFX.h>
+#include <TM16xxParallel.h>
+
+// Define the matrix modules. Arduino Nano: data pins 2, 3, 4 and 5 (PORTD), shared clock pin 6
+TM1640 module1(2, 6);
+TM1640 module2(3, 6);
+TM1640 module3(4, 6);
+TM1640 module4(5, 6);
+TM16xx * modules[]={&module1, &module2, &module3, &module4};
+
+// The bus uses the same modules as the matrix
+TM16xxParallel bus(modules, 4);
+
+#define MODULE_SIZECOLUMNS 16   // number of GRD lines per module, will be the y-height of the display
+#define MODULE_SIZEROWS 8       // number of SEG lines per module, will be the x-width of the display
+TM16xxMatrixGFX matrix(modules, MODULE_SIZECOLUMNS, MODULE_SIZEROWS, 4, 1);    // TM16xx objects, columns, rows, modulesCol, modulesRow
+
+void setup()
+{
+  Serial.begin(115200);
+  matrix.setParallel(&bus);
+  matrix.setIntensity(1); // Use a value between 0 and 7 for brightness
+}
+
+void loop()
+{
+  static int16_t x=0;
+  matrix.fillScreen(LOW);
+  matrix.drawLine(x, 0, matrix.width()-x-1, matrix.height()-1, HIGH);
+  matrix.drawPixel(0, 0, HIGH);     // mark axis-origin for reference
+
+  uint32_t tStart=micros();
+  matrix.write();     // send the bitmap of all modules at once
+  uint32_t tWrite=micros()-tStart;
+
+  if(x==0)
+  {
+    Serial.print(F("Write time (us): "));
+    Serial.println(tWrite);
+  }
+  x=(x+1)%matrix.width();
+  delay(50);
+}
@@ -0,0 +1,47 @@
+/*
+  Library example to move a sprite over an 8x8 LED matrix using TM16xxMatrix.
+  The sprite is stored column by column in PROGMEM, like the memory of the matrix (bit 0 is the top row).
+  blit() combines each column with a few shifts and logic operations instead of setting the pixels one by one.
+  XOR mode inverts the pixels of the sprite, so blitting it again at the same position restores the background.
+  The mask makes the sprite opaque in COPY mode, while its corners remain transparent.
+
+  For more information see  https://github.com/maxint-rd/TM16xx
+*/
+#include <TM1640.h>
+#include <TM16xxMatrix.h>
+#include <TM16xxSprite.h>
+
+TM1640 module(9, 10);    // DIN=9, CLK=10
+#define MATRIX_NUMCOLUMNS 8
+#define MATRIX_NUMROWS 8
+TM16xxMatrix matrix(&module, MATRIX_NUMCOLUMNS, MATRIX_NUMROWS);    // TM16xx object, columns, rows
+
+const byte PROGMEM ballData[]={0x06, 0x09, 0x09, 0x06};    // 4 columns of 4 rows: a ring
+const byte PROGMEM ballMask[]={0x06, 0x0F, 0x0F, 0x06};    // corners are transparent
+TM16xxSprite ball(ballData, 4, 4, ballMask);
+
+void setup()
+{
+  module.setupDisplay(true, 2);
+  matrix.setAll(false);
+  for(byte nCol=0; nCol<MATRIX_NUMCOLUMNS; nCol+=2)
+    matrix.setColumn(nCol, 0x55);    // dotted background
+}
+
+void loop()
+{
+  static int x=0, y=0, dx=1, dy=1;
+  static bool fCopy=false;
+  matrix.blit(x, y, ball, fCopy ? TM16XX_BLIT_COPY : TM16XX_BLIT_XOR);
+  delay(150);
+  if(!fCopy)
+    matrix.blit(x, y, ball, TM16XX_BLIT_XOR);    // restore the background
+
+  // bounce off the sides, partly moving off-screen (the sprite is clipped)
+  x+=dx;
+  y+=dy;
+  if(x<=-2 || x>=MATRIX_NUMCOLUMNS-2) dx=-dx;
+  if(y<=-2 || y>=MATRIX_NUMROWS-2) dy=-dy;
+  if(x==0 && y==0)
+    fCopy=!fCopy;    // every other round leave a trail using COPY mode
+}
@@ -0,0 +1,64 @@
+/*
+  Library example to update the display in the background.
+  In buffered mode the display data is only changed in memory. The tick() method sends one byte
+  of changed data per call. On AVR it is called from a timer interrupt, on ESP32 a FreeRTOS task is used.
+  This way the timing of loop() is not disturbed by sending display data.
+
+  On AVR this example uses the compare interrupt of Timer0, which also drives millis(), to call tick()
+  once every millisecond. On other MCUs tick() is called from loop() to simulate a timer.
+
+  For more information see  https://github.com/maxint-rd/TM16xx
+*/
+#include <TM1638.h>
+#include <TM16xxDisplay.h>
+
+// Define a TM1638 module. Pin suggestions:
+// ESP8266 (Wemos D1): data pin 5 (D1), clock pin 4 (D2), strobe pin 0 (D3)
+// Arduino Nano: data pin 8, clock pin 9, strobe pin 7
+TM1638 module(8, 9, 7);   // DIO=8, CLK=9, STB=7
+TM16xxDisplay display(&module, 8);
+
+#if defined(__AVR__)
+ISR(TIMER0_COMPA_vect)
+{ // called once every millisecond
+  module.tick();
+}
+#endif
+
+void setup()
+{
+  Serial.begin(115200);
+  module.begin(true, 2);
+#if defined(ARDUINO_ARCH_ESP32)
+  module.startBackgroundTask();
+#else
+  module.setBuffered(true);
+#endif
+#if defined(__AVR__)
+  OCR0A = 0x80;           // interrupt halfway the count of Timer0
+  TIMSK0 |= _BV(OCIE0A);  // enable the compare interrupt
+#endif
+}
+
+uint32_t tLastTick=0;
+uint32_t nCount=0;
+
+void loop()
+{
+  // The display is only changed in memory, the background refresh will send the data.
+  // Reading the buttons is also safe: the background refresh pauses while the buttons are read.
+  uint32_t dwButtons=module.getButtons();
+  if(dwButtons)
+    nCount=0;
+  display.setDisplayToDecNumber(nCount++, 0, false);
+  delay(10);
+
+#if !defined(__AVR__) && !defined(ARDUINO_ARCH_ESP32)
+  // simulate a timer interrupt
+  while(millis()!=tLastTick)
+  {
+    tLastTick++;
+    module.tick();
+  }
+#endif
+}
@@ -0,0 +1,64 @@
+/*
+  Library example to measure the speed of sending data to a TM16xx chip.
+  It compares sending each byte using setSegments() with buffered mode using flush().
+  To see the effect of direct GPIO register access (TM16XX_OPT_FASTGPIO) use the TM16xxGPIO_benchmark example.
+
+  The results are printed on the serial console.
+
+  For more information see  https://github.com/maxint-rd/TM16xx
+*/
+#include <TM1638.h>
+
+// Define a TM1638 module. Pin suggestions:
+// ESP8266 (Wemos D1): data pin 5 (D1), clock pin 4 (D2), strobe pin 0 (D3)
+// Arduino Nano: data pin 8, clock pin 9, strobe pin 7
+TM1638 module(8, 9, 7);   // DIO=8, CLK=9, STB=7
+
+#define BENCH_ROUNDS 100
+
+void showResult(const char *szTitle, uint32_t tStart, uint32_t nBytes)
+{
+  uint32_t tDuration=micros()-tStart;
+  Serial.print(szTitle);
+  Serial.print(F(": "));
+  Serial.print(tDuration/BENCH_ROUNDS);
+  Serial.print(F(" us per frame, "));
+  Serial.print(nBytes*1000000UL/tDuration);
+  Serial.println(F(" bytes/sec"));
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  module.begin(true, 2);
+  Serial.print(F("TM16xx benchmark, fast GPIO "));
+  Serial.println(TM16XX_OPT_FASTGPIO ? F("enabled") : F("disabled"));
+}
+
+void loop()
+{
+  uint32_t tStart;
+
+  // send 8 digits per frame using fixed addressing, each frame has different data
+  module.resetWriteCounters();
+  tStart=micros();
+  for(int n=0; n<BENCH_ROUNDS; n++)
+    for(byte nPos=0; nPos<8; nPos++)
+      module.setSegments(n+nPos, nPos);
+  showResult("setSegments()", tStart, module.getWritesPerformed());
+
+  // same frames in buffered mode, sent in one burst per frame
+  module.setBuffered(true);
+  module.resetWriteCounters();
+  tStart=micros();
+  for(int n=0; n<BENCH_ROUNDS; n++)
+  {
+    for(byte nPos=0; nPos<8; nPos++)
+      module.setSegments(n+nPos+1, nPos);
+    module.flush();
+  }
+  showResult("flush()", tStart, module.getWritesPerformed());
+  module.setBuffered(false);
+
+  delay(2000);
+}
@@ -0,0 +1,50 @@
+/*
+  Library example to update the display without blocking loop() for a long time.
+  In buffered mode printing only changes the shadow RAM of the module. Calling service() in loop()
+  then sends a few bytes at a time, so other time critical tasks can run in between.
+  Each call of service() sends at most the specified number of bytes (or runs at most the specified
+  number of microseconds). A digit that uses two bytes (e.g. TM1638) is always updated at once.
+
+  For more information see  https://github.com/maxint-rd/TM16xx
+*/
+#include <TM1638.h>
+#include <TM16xxDisplay.h>
+
+// Define a TM1638 module. Pin suggestions:
+// ESP8266 (Wemos D1): data pin 5 (D1), clock pin 4 (D2), strobe pin 0 (D3)
+// Arduino Nano: data pin 8, clock pin 9, strobe pin 7
+TM1638 module(8, 9, 7);   // DIO=8, CLK=9, STB=7
+TM16xxDisplay display(&module, 8);
+
+uint32_t tLastCount=0;
+uint32_t nCount=0;
+uint32_t nLoops=0;
+
+void setup()
+{
+  Serial.begin(115200);
+  module.begin(true, 2);
+  display.setBuffered(true);
+}
+
+void loop()
+{
+  // Count every 100ms. The display is only changed in memory.
+  if(millis()-tLastCount>=100)
+  {
+    tLastCount=millis();
+    display.setDisplayToDecNumber(nCount++, 0, false);
+    if(nCount%10==0)
+    {
+      Serial.print(F("Loops per second: "));
+      Serial.println(nLoops);
+      nLoops=0;
+    }
+  }
+
+  // Send at most 4 bytes per call or stop after 200us, whatever comes first
+  display.service(4, 200);
+
+  // Other work can be done here without long interruptions
+  nLoops++;
+}
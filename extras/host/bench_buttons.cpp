@@ -0,0 +1,159 @@
+/*
+bench_buttons.cpp - Host benchmark of TM16xxButtons::tick(). See README.md
+
+Compares the current tick() with the version that ran the state machine for all 32 buttons at every call
+(baseline/TM16xxButtonsOld). Both are fed the same sequence of simulated getButtons() results and the same
+simulated time. First the callbacks of both versions are compared, then the time per tick() is measured:
+with no button pressed, with one button held, and for a random sequence of presses over 12 keys.
+The module is simulated, so the time to read the keys from the chip is not included.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "sim.h"
+#include "TM1638.h"
+#include "TM16xxButtons.h"
+#include "baseline/TM16xxButtonsOld.h"
+
+#define SEQUENCE_STEPS 200000
+#define TIMED_TICKS 2000000L
+
+class TM1638Keys : public TM1638
+{ // returns the simulated keys instead of reading the chip
+ public:
+  TM1638Keys() : TM1638(8, 9, 7) {}
+  virtual uint32_t getButtons() { return(dwKeys); }
+  uint32_t dwKeys=0;
+};
+
+struct SequenceStep
+{
+  uint32_t dwKeys;      // result of getButtons()
+  byte nDelay;          // msec before the tick
+};
+
+struct CallbackEvent
+{
+  unsigned long tEvent;
+  byte nEvent;
+  byte nButton;
+  bool operator!=(const CallbackEvent &other) const
+    { return(tEvent!=other.tEvent || nEvent!=other.nEvent || nButton!=other.nButton); }
+};
+
+static std::vector<CallbackEvent> *pLog=NULL;    // log of the version being ticked
+
+static void logEvent(byte nEvent, byte nButton)
+{
+  if(pLog)
+    pLog->push_back(CallbackEvent{ millis(), nEvent, nButton });
+}
+static void onRelease(byte nButton) { logEvent(TM16XX_BUTTONS_EVENT_RELEASE, nButton); }
+static void onClick(byte nButton) { logEvent(TM16XX_BUTTONS_EVENT_CLICK, nButton); }
+static void onDoubleClick(byte nButton) { logEvent(TM16XX_BUTTONS_EVENT_DOUBLECLICK, nButton); }
+static void onLongPressStart(byte nButton) { logEvent(TM16XX_BUTTONS_EVENT_LONGPRESSSTART, nButton); }
+static void onLongPressStop(byte nButton) { logEvent(TM16XX_BUTTONS_EVENT_LONGPRESSSTOP, nButton); }
+static void onDuringLongPress(byte nButton) { logEvent(TM16XX_BUTTONS_EVENT_LONGPRESSBUSY, nButton); }
+
+template <class Buttons> static void attachAll(Buttons &buttons)
+{
+  buttons.attachRelease(onRelease);
+  buttons.attachClick(onClick);
+  buttons.attachDoubleClick(onDoubleClick);
+  buttons.attachLongPressStart(onLongPressStart);
+  buttons.attachLongPressStop(onLongPressStop);
+  buttons.attachDuringLongPress(onDuringLongPress);
+}
+
+static std::vector<SequenceStep> makeSequence()
+{ // random presses and releases of 12 keys, sometimes all keys are released
+  std::vector<SequenceStep> vSteps;
+  uint32_t dwSeed=1, dwKeys=0;
+  for(long n=0; n<SEQUENCE_STEPS; n++)
+  {
+    dwSeed=dwSeed*1103515245UL+12345;
+    uint32_t r=dwSeed>>8;
+    if(r%40==0)
+      dwKeys^=bit((r>>6)%12);
+    if(r%500==1)
+      dwKeys=0;
+    vSteps.push_back(SequenceStep{ dwKeys, (byte)((r>>12)%5) });
+  }
+  return(vSteps);
+}
+
+static double now()
+{
+  return(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+template <class Buttons> static double timeSequence(TM1638Keys &module, Buttons &buttons, const std::vector<SequenceStep> &vSteps)
+{ // nsec per tick() for the sequence, including the loop
+  buttons.reset();
+  double t=now();
+  for(const SequenceStep &step : vSteps)
+  {
+    module.dwKeys=step.dwKeys;
+    simAdvance(step.nDelay*1000UL);
+    buttons.tick();
+  }
+  return((now()-t)/vSteps.size());
+}
+
+template <class Buttons> static double timeConstant(TM1638Keys &module, Buttons &buttons, uint32_t dwKeys)
+{ // nsec per tick() while the keys don't change
+  buttons.reset();
+  module.dwKeys=dwKeys;
+  double t=now();
+  for(long n=0; n<TIMED_TICKS; n++)
+    buttons.tick();
+  return((now()-t)/TIMED_TICKS);
+}
+
+static void report(const char *szTitle, double dOld, double dNew)
+{
+  printf("  %-28s old %7.1f ns, new %7.1f ns, %6.1fx\n", szTitle, dOld, dNew, dOld/dNew);
+}
+
+int main()
+{
+  TM1638Keys moduleOld, moduleNew;
+  TM16xxButtonsOld buttonsOld(&moduleOld);
+  TM16xxButtons buttonsNew(&moduleNew);
+  attachAll(buttonsOld);
+  attachAll(buttonsNew);
+  std::vector<SequenceStep> vSteps=makeSequence();
+
+  // Both versions should give the same callbacks at the same times
+  std::vector<CallbackEvent> vLogOld, vLogNew;
+  for(const SequenceStep &step : vSteps)
+  {
+    simAdvance(step.nDelay*1000UL);
+    moduleOld.dwKeys=moduleNew.dwKeys=step.dwKeys;
+    pLog=&vLogOld;
+    buttonsOld.tick();
+    pLog=&vLogNew;
+    buttonsNew.tick();
+  }
+  pLog=NULL;
+  size_t nSame=0;
+  while(nSame<vLogOld.size() && nSame<vLogNew.size() && !(vLogOld[nSame]!=vLogNew[nSame]))
+    nSame++;
+  bool fSame=(nSame==vLogOld.size() && nSame==vLogNew.size());
+  printf("bench_buttons: %d steps, %u callbacks, %s\n", SEQUENCE_STEPS, (unsigned)vLogOld.size(),
+    fSame ? "same callbacks" : "DIFFERENT callbacks");
+  if(!fSame)
+  {
+    printf("  first difference at callback %u\n", (unsigned)nSame);
+    return(1);
+  }
+
+  report("no button pressed", timeConstant(moduleOld, buttonsOld, 0), timeConstant(moduleNew, buttonsNew, 0));
+  report("one button held", timeConstant(moduleOld, buttonsOld, bit(4)), timeConstant(moduleNew, buttonsNew, bit(4)));
+  report("random sequence of 12 keys", timeSequence(moduleOld, buttonsOld, vSteps), timeSequence(moduleNew, buttonsNew, vSteps));
+  return(0);
+}
@@ -0,0 +1,137 @@
+/*
+bench_gfx.cpp - Host benchmark of the byte-wise drawing methods of TM16xxMatrixGFX. See README.md
+
+Measures the time to draw text like the TM16xxMatrixGFX_Ticker example, to fill rectangles, to draw bitmaps and sprites.
+"pixel" is the time when drawn pixel by pixel, the way Adafruit GFX draws it using drawPixel(), "fast" is the time
+using the methods of TM16xxMatrixGFX. Only the drawing is measured, not sending the data to the modules.
+Absolute times of the host don't apply to an MCU, but the ratio gives an indication of the gain.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#include <stdio.h>
+#include <chrono>
+#include "sim.h"
+#include "TM1640.h"
+#include "TM16xxMatrixGFX.h"
+#include "TM16xxSprite.h"
+
+#define ROUNDS 2000
+
+static double now()
+{
+  return(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static void report(const char *szTitle, double dPixel, double dFast)
+{
+  printf("  %-28s pixel %7.2f us, fast %7.2f us, %5.1fx\n", szTitle, dPixel/ROUNDS, dFast/ROUNDS, dPixel/dFast);
+}
+
+static void benchTicker(TM16xxMatrixGFX &matrix, byte nRotation)
+{ // scroll a text over the display, like the TM16xxMatrixGFX_Ticker example
+  const char *szText="TM16xx ticker";
+  matrix.setRotation(nRotation);
+  matrix.setTextWrap(false);
+  double dPixel=0, dFast=0;
+  for(byte nPass=0; nPass<2; nPass++)
+  {
+    double t=now();
+    for(int n=0; n<ROUNDS; n++)
+    {
+      matrix.fillScreen(0);
+      matrix.setCursor(matrix.width()-(n%80), 0);
+      for(const char *p=szText; *p; p++)
+      {
+        if(nPass)
+          matrix.write((uint8_t)*p);
+        else
+          matrix.Adafruit_GFX::write((uint8_t)*p);
+      }
+    }
+    (nPass ? dFast : dPixel)=now()-t;
+  }
+  char szTitle[40];
+  snprintf(szTitle, sizeof(szTitle), "ticker text, rotation %d", nRotation);
+  report(szTitle, dPixel, dFast);
+}
+
+static void benchFillRect(TM16xxMatrixGFX &matrix)
+{
+  matrix.setRotation(0);
+  double t=now();
+  for(int n=0; n<ROUNDS; n++)
+    for(int16_t y=0; y<matrix.height(); y++)
+      for(int16_t x=0; x<matrix.width(); x++)
+        matrix.drawPixel(x, y, n&1);
+  double dPixel=now()-t;
+  t=now();
+  for(int n=0; n<ROUNDS; n++)
+    matrix.fillRect(0, 0, matrix.width(), matrix.height(), n&1);
+  report("fillRect, full screen", dPixel, now()-t);
+}
+
+static void benchBitmap(TM16xxMatrixGFX &matrix, byte nRotation)
+{
+  static const uint8_t aBitmap[] PROGMEM={ 0x3C, 0x42, 0xA5, 0x81, 0xA5, 0x99, 0x42, 0x3C };
+  matrix.setRotation(nRotation);
+  double t=now();
+  for(int n=0; n<ROUNDS; n++)
+    for(int16_t j=0; j<8; j++)
+      for(int16_t i=0; i<8; i++)
+        if(pgm_read_byte(&aBitmap[j]) & (0x80>>i))
+          matrix.drawPixel(n%8+i, j, 1);
+  double dPixel=now()-t;
+  t=now();
+  for(int n=0; n<ROUNDS; n++)
+    matrix.drawBitmap(n%8, 0, aBitmap, 8, 8, 1);
+  char szTitle[40];
+  snprintf(szTitle, sizeof(szTitle), "drawBitmap 8x8, rotation %d", nRotation);
+  report(szTitle, dPixel, now()-t);
+}
+
+static void benchBlit(TM16xxMatrixGFX &matrix, byte nRotation, byte nMode)
+{ // 8x8 sprite using OR or XOR
+  static const byte aData[] PROGMEM={ 0x3C, 0x42, 0xA5, 0x81, 0xA5, 0x99, 0x42, 0x3C };
+  TM16xxSprite sprite(aData, 8, 8);
+  matrix.setRotation(nRotation);
+  double t=now();
+  for(int n=0; n<ROUNDS; n++)
+    for(int16_t i=0; i<8; i++)
+      for(int16_t j=0; j<8; j++)
+        if(pgm_read_byte(&aData[i]) & bit(j))
+          matrix.drawPixel(n%8+i, j, nMode==TM16XX_BLIT_XOR ? !matrix.getPixel(n%8+i, j) : 1);
+  double dPixel=now()-t;
+  t=now();
+  for(int n=0; n<ROUNDS; n++)
+    matrix.blit(n%8, 0, sprite, nMode);
+  char szTitle[40];
+  snprintf(szTitle, sizeof(szTitle), "blit 8x8 %s, rotation %d", nMode==TM16XX_BLIT_XOR ? "XOR" : "OR", nRotation);
+  report(szTitle, dPixel, now()-t);
+}
+
+int main()
+{
+  TM1640 module(2, 9);
+  TM16xxMatrixGFX matrix(&module, 16, 8);
+  printf("bench_gfx: single TM1640 16x8\n");
+  benchTicker(matrix, 1);
+  benchTicker(matrix, 0);
+  benchFillRect(matrix);
+  benchBitmap(matrix, 1);
+  benchBitmap(matrix, 0);
+  benchBlit(matrix, 1, TM16XX_BLIT_OR);
+  benchBlit(matrix, 0, TM16XX_BLIT_OR);
+  benchBlit(matrix, 0, TM16XX_BLIT_XOR);
+
+  TM1640 m1(2, 9), m2(3, 9), m3(4, 9), m4(5, 9);
+  TM16xx *aModules[]={&m1, &m2, &m3, &m4};
+  TM16xxMatrixGFX matrix4(aModules, 8, 8, 4, 1);
+  printf("bench_gfx: four 8x8 modules in a row\n");
+  benchTicker(matrix4, 0);
+  benchFillRect(matrix4);
+  benchBitmap(matrix4, 0);
+  benchBlit(matrix4, 0, TM16XX_BLIT_OR);
+  benchBlit(matrix4, 0, TM16XX_BLIT_XOR);
+  return(0);
+}
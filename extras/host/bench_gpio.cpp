@@ -0,0 +1,82 @@
+/*
+bench_gpio.cpp - Host benchmark of the pin accesses of TM16xx. See README.md
+
+Counts the pin accesses of common operations of a TM1638 using the pin simulator, and checks that the simulated
+chip received the expected data. On the host TM16xxFastPin falls back to digitalWrite(), so the time of a pin
+access can't be measured here. Instead the counts are multiplied by the typical AVR cost of each access:
+  digitalWrite()/digitalRead()   about 50 cycles, the port and mask of the pin are looked up on every call
+  TM16xxFastPin::write()         about 10 cycles, read-modify-write of the cached port with interrupts disabled
+  TM16xxFastPin::read()          about 5 cycles
+pinMode() is used the same way by both and is counted at 50 cycles. The estimate is for an AVR at 16 MHz without
+bitDelay() (as used on AVR) and leaves out the remaining code of send() and receive(). Use the TM16xxGPIO_benchmark
+example to measure the actual gain on an MCU.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#include <stdio.h>
+#include "sim.h"
+#include "TM1638.h"
+
+#define CYCLES_DIGITAL 50     // digitalWrite(), digitalRead() or pinMode() on AVR
+#define CYCLES_FASTWRITE 10   // TM16xxFastPin::write() on AVR
+#define CYCLES_FASTREAD 5     // TM16xxFastPin::read() on AVR
+#define CYCLES_PER_US 16
+
+static int nFailed=0;
+
+static void report(const char *szTitle, unsigned long uWrites, unsigned long uReads, unsigned long uModes)
+{
+  double dDigital=(uWrites+uReads+uModes)*CYCLES_DIGITAL/(double)CYCLES_PER_US;
+  double dFast=(uWrites*CYCLES_FASTWRITE+uReads*CYCLES_FASTREAD+uModes*CYCLES_DIGITAL)/(double)CYCLES_PER_US;
+  printf("  %-26s %4lu writes %3lu reads %2lu modes, digitalWrite %6.1f us, fast %6.1f us, %4.1fx\n",
+    szTitle, uWrites, uReads, uModes, dDigital, dFast, dDigital/dFast);
+}
+
+static void startCount()
+{
+  simPinWrites=0;
+  simPinReads=0;
+  simPinModes=0;
+}
+
+static void expect(bool fOk, const char *szWhat)
+{
+  if(!fOk)
+  {
+    printf("FAIL: %s\n", szWhat);
+    nFailed++;
+  }
+}
+
+int main()
+{
+  TM1638 module(8, 9, 7);
+  simAttach(8, 9, 7);
+  module.begin();
+  printf("bench_gpio: TM1638, estimated pin access time on AVR at 16 MHz\n");
+
+  startCount();
+  module.setSegments(0x5B, 3);
+  report("setSegments(), one digit", simPinWrites, simPinReads, simPinModes);
+  expect(simRam[6]==0x5B, "setSegments() data");
+
+  startCount();
+  module.setDisplayToString("12345678");
+  report("setDisplayToString(), 8", simPinWrites, simPinReads, simPinModes);
+  expect(simRam[0]!=0 && simRam[14]!=0, "setDisplayToString() data");
+
+  simKeys[0]=0x01;
+  startCount();
+  uint32_t dwButtons=module.getButtons();
+  report("getButtons()", simPinWrites, simPinReads, simPinModes);
+  expect(dwButtons==bit(16), "getButtons() result");
+
+  startCount();
+  module.clearDisplay();
+  report("clearDisplay()", simPinWrites, simPinReads, simPinModes);
+  expect(simRam[0]==0 && simRam[14]==0, "clearDisplay() data");
+
+  printf("bench_gpio: %s\n", nFailed ? "FAILED" : "data checked");
+  return(nFailed ? 1 : 0);
+}
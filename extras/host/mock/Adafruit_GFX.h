@@ -0,0 +1,121 @@
+/*
+Adafruit_GFX.h - Minimal Adafruit GFX API for building the TM16xx library on the host. See ../README.md
+Text in the classic font is drawn like Adafruit GFX does (drawChar() uses writePixel(), or writeFillRect() for larger
+sizes), but the font table is generated. Other drawing methods that TM16xxMatrixGFX doesn't override do nothing.
+*/
+
+#ifndef ADAFRUIT_GFX_MOCK_h
+#define ADAFRUIT_GFX_MOCK_h
+
+#include "Arduino.h"
+
+class Adafruit_GFX : public Print
+{
+  public:
+    Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color)=0;
+    virtual void startWrite() {}
+    virtual void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+    virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { fillRect(x, y, w, h, color); }
+    virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); }
+    virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { drawFastHLine(x, y, w, color); }
+    virtual void endWrite() {}
+    virtual void setRotation(uint8_t r)
+    {
+      rotation=r&3;
+      _width=(rotation&1) ? HEIGHT : WIDTH;
+      _height=(rotation&1) ? WIDTH : HEIGHT;
+    }
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {}
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {}
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {}
+    virtual void fillScreen(uint16_t color) {}
+    virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {}
+    virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {}
+    virtual size_t write(uint8_t c)
+    { // classic font only, same cursor handling as Adafruit GFX
+      if(c=='\n')
+      {
+        cursor_x=0;
+        cursor_y+=textsize_y*8;
+      }
+      else if(c!='\r')
+      {
+        if(wrap && (cursor_x+textsize_x*6)>_width)
+        {
+          cursor_x=0;
+          cursor_y+=textsize_y*8;
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+        cursor_x+=textsize_x*6;
+      }
+      return(1);
+    }
+
+    static uint8_t fontColumn(unsigned char c, uint8_t i)
+    { // generated 5x7 glyphs instead of the font table of Adafruit GFX, bit 7 is unused like in that font
+      return(c==' ' ? 0 : ((c*37+i*101)^(c>>1)^(i*i*13)) & 0x7F);
+    }
+
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y)
+    { // same algorithm as the classic font of Adafruit GFX
+      if(x>=_width || y>=_height || (x+6*size_x-1)<0 || (y+8*size_y-1)<0)
+        return;
+      startWrite();
+      for(int8_t i=0; i<5; i++)
+      {
+        uint8_t line=fontColumn(c, i);
+        for(int8_t j=0; j<8; j++, line>>=1)
+        {
+          if(line & 1)
+          {
+            if(size_x==1 && size_y==1)
+              writePixel(x+i, y+j, color);
+            else
+              writeFillRect(x+i*size_x, y+j*size_y, size_x, size_y, color);
+          }
+          else if(bg!=color)
+          {
+            if(size_x==1 && size_y==1)
+              writePixel(x+i, y+j, bg);
+            else
+              writeFillRect(x+i*size_x, y+j*size_y, size_x, size_y, bg);
+          }
+        }
+      }
+      if(bg!=color)
+      { // opaque: last column
+        if(size_x==1 && size_y==1)
+          writeFastVLine(x+5, y, 8, bg);
+        else
+          writeFillRect(x+5*size_x, y, size_x, 8*size_y, bg);
+      }
+      endWrite();
+    }
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) { drawChar(x, y, c, color, bg, size, size); }
+    void drawCircle(int16_t x, int16_t y, int16_t r, uint16_t color) {}
+    void fillCircle(int16_t x, int16_t y, int16_t r, uint16_t color) {}
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) {}
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg) {}
+    void setCursor(int16_t x, int16_t y) { cursor_x=x; cursor_y=y; }
+    void setTextWrap(bool w) { wrap=w; }
+    void setTextColor(uint16_t c) { textcolor=textbgcolor=c; }
+    void setTextColor(uint16_t c, uint16_t bg) { textcolor=c; textbgcolor=bg; }
+    void setTextSize(uint8_t s) { textsize_x=textsize_y=s; }
+    int16_t width() const { return(_width); }
+    int16_t height() const { return(_height); }
+    uint8_t getRotation() const { return(rotation); }
+
+  protected:
+    const int16_t WIDTH, HEIGHT;
+    int16_t _width, _height;
+    int16_t cursor_x=0, cursor_y=0;
+    uint16_t textcolor=0xFFFF, textbgcolor=0xFFFF;
+    uint8_t textsize_x=1, textsize_y=1;
+    uint8_t rotation=0;
+    bool wrap=true;
+    void *gfxFont=NULL;
+};
+
+#endif
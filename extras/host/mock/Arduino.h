@@ -0,0 +1,120 @@
+/*
+Arduino.h - Minimal Arduino API for building the TM16xx library on the host. See ../README.md
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#ifndef ARDUINO_MOCK_h
+#define ARDUINO_MOCK_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+
+typedef uint8_t byte;
+typedef uint16_t word;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define LSBFIRST 0
+#define MSBFIRST 1
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+#ifndef F_CPU
+  #define F_CPU 16000000L
+#endif
+#define NUM_DIGITAL_PINS 20
+
+#define PROGMEM
+#define pgm_read_byte_near(p) (*(const uint8_t *)(p))
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+
+#define bit(b) (1UL << (b))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+
+// implemented by the pin simulator (sim.cpp)
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long millis();
+unsigned long micros();
+void noInterrupts();
+void interrupts();
+
+class String
+{
+  public:
+    const char *c_str() const { return(""); }
+};
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+class Print
+{
+  public:
+    virtual size_t write(uint8_t c)=0;
+    virtual void flush() {}
+    size_t print(const char *s) { size_t n=0; while(*s) n+=write(*s++); return(n); }
+    size_t print(const __FlashStringHelper *s) { return(print((const char *)s)); }
+    size_t print(char c) { return(write(c)); }
+    size_t print(long n, int base=DEC) { return(printNumber(n, base)); }
+    size_t print(unsigned long n, int base=DEC) { return(printNumber(n, base)); }
+    size_t print(int n, int base=DEC) { return(printNumber(n, base)); }
+    size_t print(unsigned n, int base=DEC) { return(printNumber(n, base)); }
+    size_t print(double d, int nDigits=2) { return(printNumber((long)d, DEC)); }
+    size_t println(const char *s="") { return(print(s)+print("\r\n")); }
+    size_t println(const __FlashStringHelper *s) { return(println((const char *)s)); }
+    size_t println(long n, int base=DEC) { return(print(n, base)+println()); }
+    size_t println(unsigned long n, int base=DEC) { return(print(n, base)+println()); }
+    size_t println(int n, int base=DEC) { return(print(n, base)+println()); }
+    size_t println(unsigned n, int base=DEC) { return(print(n, base)+println()); }
+
+  private:
+    size_t printNumber(long n, int base)
+    {
+      char sz[34];
+      char *p=sz+sizeof(sz)-1;
+      bool fNeg=(n<0 && base==DEC);
+      unsigned long u=fNeg ? -n : n;
+      *p='\0';
+      do { *--p="0123456789ABCDEF"[u%base]; u/=base; } while(u);
+      if(fNeg)
+        *--p='-';
+      return(print(p));
+    }
+};
+
+class Stream : public Print
+{
+  public:
+    virtual int available() { return(0); }
+    virtual int read() { return(-1); }
+};
+
+class HardwareSerial : public Stream
+{
+  public:
+    void begin(unsigned long uBaud, uint8_t nConfig=0) {}
+    void end() {}
+    virtual size_t write(uint8_t c);    // written to stdout
+    int availableForWrite() { return(1); }
+};
+#define SERIAL_8E1 0x26
+#define SERIAL_8O1 0x36
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,5 @@
+/*
+Print.h - The Print class is part of the mock Arduino.h. See ../README.md
+*/
+
+#include "Arduino.h"
@@ -0,0 +1,28 @@
+/*
+SPI.h - Minimal Arduino SPI API for building the TM16xx library on the host. See ../README.md
+*/
+
+#ifndef SPI_MOCK_h
+#define SPI_MOCK_h
+
+#include "Arduino.h"
+
+#define SPI_MODE3 3
+
+class SPISettings
+{
+  public:
+    SPISettings(uint32_t uClock, uint8_t nBitOrder, uint8_t nMode) {}
+};
+
+class SPIClass
+{
+  public:
+    void begin() {}
+    void beginTransaction(SPISettings settings) {}
+    void endTransaction() {}
+    uint8_t transfer(uint8_t data) { return(data); }
+};
+extern SPIClass SPI;
+
+#endif
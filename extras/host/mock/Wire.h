@@ -0,0 +1,26 @@
+/*
+Wire.h - Minimal Arduino Wire API for building the TM16xx library on the host. See ../README.md
+*/
+
+#ifndef WIRE_MOCK_h
+#define WIRE_MOCK_h
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 32
+
+class TwoWire
+{
+  public:
+    void begin() {}
+    void setClock(uint32_t uClock) {}
+    void beginTransmission(uint8_t address) {}
+    uint8_t endTransmission(bool fStop=true) { return(0); }
+    size_t write(uint8_t data) { return(1); }
+    uint8_t requestFrom(uint8_t address, uint8_t nBytes) { return(0); }
+    int read() { return(-1); }
+    int available() { return(0); }
+};
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,189 @@
+/*
+sim.cpp - Host pin simulator for testing the TM16xx library without hardware. See sim.h
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#include <stdio.h>
+#include "sim.h"
+#include "SPI.h"
+#include "Wire.h"
+
+HardwareSerial Serial;
+SPIClass SPI;
+TwoWire Wire;
+
+std::vector<SimFrame> simFrames;
+byte simRam[SIM_RAM_SIZE];
+byte simDisplayControl=0;
+byte simKeys[SIM_KEY_BYTES];
+unsigned long simPinWrites=0;
+unsigned long simPinReads=0;
+unsigned long simPinModes=0;
+bool simInterruptsEnabled=true;
+
+static byte _aPinLevel[256];
+static unsigned long _uMicros=0;
+
+// state of the simulated chip
+static byte _nDataPin=0xFF, _nClockPin=0xFF, _nStrobePin=0xFF;
+static bool _fInFrame=false;
+static SimFrame _frame;
+static byte _btShift=0, _nBits=0;
+static byte _btDataCmd=0x40;
+static byte _nAddress=0;
+static bool _fReading=false;
+static byte _nReadByte=0;
+static byte _btOut=1;       // DIO level driven by the chip while reading keys
+
+void simAttach(byte dataPin, byte clockPin, byte strobePin)
+{
+  _nDataPin=dataPin;
+  _nClockPin=clockPin;
+  _nStrobePin=strobePin;
+  _fInFrame=false;
+  _fReading=false;
+  _btDataCmd=0x40;
+  memset(simRam, 0, sizeof(simRam));
+  memset(simKeys, 0, sizeof(simKeys));
+  simDisplayControl=0;
+  simFrames.clear();
+}
+
+static void simReceive(byte data)
+{ // apply a byte received by the chip
+  if(_frame.empty())
+  { // first byte of a frame is a command
+    if((data & 0xC0)==0x40)
+    {
+      _btDataCmd=data;
+      _fReading=((data & 0x03)==0x02);
+      _nReadByte=0;
+    }
+    else if((data & 0xC0)==0x80)
+      simDisplayControl=data;
+    else if((data & 0xC0)==0xC0)
+      _nAddress=data & 0x0F;
+  }
+  else if((_frame[0] & 0xC0)==0xC0)
+  { // display data following an address command
+    simRam[_nAddress % SIM_RAM_SIZE]=data;
+    if(!(_btDataCmd & 0x04))
+      _nAddress++;    // auto increment, unless fixed addressing was set
+  }
+  _frame.push_back(data);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  simPinModes++;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{
+  simPinWrites++;
+  byte btPrev=_aPinLevel[pin];
+  _aPinLevel[pin]=level ? HIGH : LOW;
+  if(pin==_nStrobePin && btPrev!=_aPinLevel[pin])
+  {
+    if(!level)
+    { // start of a frame
+      _fInFrame=true;
+      _frame.clear();
+      _nBits=0;
+      _btShift=0;
+    }
+    else if(_fInFrame)
+    {
+      simFrames.push_back(_frame);
+      _fInFrame=false;
+      _fReading=false;
+    }
+  }
+  else if(pin==_nClockPin && _fInFrame && btPrev!=_aPinLevel[pin])
+  {
+    if(!level && _fReading && !_frame.empty())
+    { // the chip outputs the next key bit after the falling edge
+      _btOut=(_nReadByte<SIM_KEY_BYTES) ? (simKeys[_nReadByte]>>_nBits) & 1 : 1;
+    }
+    else if(level)
+    { // data is sampled on the rising edge
+      byte btBit=(_fReading && !_frame.empty()) ? _btOut : _aPinLevel[_nDataPin];
+      _btShift|=btBit<<_nBits;
+      if(++_nBits==8)
+      {
+        if(_fReading && !_frame.empty())
+        {
+          _frame.push_back(_btShift);
+          _nReadByte++;
+        }
+        else
+          simReceive(_btShift);
+        _nBits=0;
+        _btShift=0;
+      }
+    }
+  }
+}
+
+int digitalRead(uint8_t pin)
+{
+  simPinReads++;
+  if(pin==_nDataPin && _fInFrame && _fReading && !_frame.empty())
+    return(_btOut);
+  return(_aPinLevel[pin]);
+}
+
+void delay(unsigned long ms)
+{
+  _uMicros+=ms*1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  _uMicros+=us;
+}
+
+unsigned long millis()
+{
+  return(_uMicros/1000);
+}
+
+unsigned long micros()
+{
+  return(_uMicros);
+}
+
+void simAdvance(unsigned long uMicros)
+{
+  _uMicros+=uMicros;
+}
+
+void noInterrupts()
+{
+  simInterruptsEnabled=false;
+}
+
+void interrupts()
+{
+  simInterruptsEnabled=true;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  putchar(c);
+  return(1);
+}
+
+void simPrintFrames(const char *szTitle)
+{
+  printf("%s: %u frames\n", szTitle, (unsigned)simFrames.size());
+  for(size_t n=0; n<simFrames.size(); n++)
+  {
+    printf("  ");
+    for(size_t i=0; i<simFrames[n].size(); i++)
+      printf("%02X ", simFrames[n][i]);
+    printf("\n");
+  }
+  simFrames.clear();
+}
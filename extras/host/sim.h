@@ -0,0 +1,37 @@
+/*
+sim.h - Host pin simulator for testing the TM16xx library without hardware. See README.md
+
+Implements the Arduino pin and time functions of the mock Arduino.h and simulates a TM1638-like chip connected
+to a 3-wire bus (DIO/CLK/STB). Bits are sampled on the rising edge of CLK while STB is low, LSB first. Each frame
+(the bytes sent while STB is low) is recorded. Like the real chip, the model applies the data and address commands
+to its display RAM and sends the key data after a read command.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#ifndef TM16XXSIM_h
+#define TM16XXSIM_h
+
+#include <vector>
+#include "Arduino.h"
+
+#define SIM_RAM_SIZE 16
+#define SIM_KEY_BYTES 4
+
+typedef std::vector<byte> SimFrame;
+
+void simAttach(byte dataPin, byte clockPin, byte strobePin);   // connect the simulated chip to these pins and reset it
+
+extern std::vector<SimFrame> simFrames;       // frames received since the last simAttach() or clear()
+extern byte simRam[SIM_RAM_SIZE];             // display RAM of the simulated chip
+extern byte simDisplayControl;                // last display control command (0x80-0x8F)
+extern byte simKeys[SIM_KEY_BYTES];           // key data sent after a read command
+extern unsigned long simPinWrites;            // number of digitalWrite() calls
+extern unsigned long simPinReads;             // number of digitalRead() calls
+extern unsigned long simPinModes;             // number of pinMode() calls
+extern bool simInterruptsEnabled;             // cleared by noInterrupts(), set by interrupts()
+
+void simAdvance(unsigned long uMicros);       // advance the simulated time of millis() and micros()
+void simPrintFrames(const char *szTitle);     // print the recorded frames and clear them
+
+#endif
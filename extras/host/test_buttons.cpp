@@ -0,0 +1,321 @@
+/*
+test_buttons.cpp - Host test of TM16xxButtons. See README.md
+
+The keys are simulated by a module that returns a given word from getButtons() and counts the reads.
+ - debounce: bouncing samples of all 32 keys are debounced for each number of samples (1-15). After every tick the
+   debounced keys must equal a model that keeps a counter per key.
+ - queue: events of clicks and long presses are read using pollEvent(). A full queue drops the new events, the
+   indexes wrap around, LONGPRESSBUSY is not queued, and once pollEvent() was called double clicks are detected.
+ - scan: the number of key reads per second of ticking every msec, by default and with setScanInterval().
+ - repeat: the times of the accelerating auto-repeat of a held key, and chords. This needs TM16XX_OPT_BUTTONS_REPEAT,
+   which the Makefile sets for this test.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#include <stdio.h>
+#include <vector>
+#include "sim.h"
+#include "TM1638.h"
+#include "TM16xxButtons.h"
+
+#define DEBOUNCE_STEPS 20000
+#define QUEUE_ROUNDS 150
+
+static int nFailed=0;
+
+#define CHECK(cond, msg) do { if(!(cond)) { printf("FAIL: %s\n", msg); nFailed++; } } while(0)
+
+class TM1638Keys : public TM1638
+{ // returns the simulated keys instead of reading the chip, and counts the reads
+ public:
+  TM1638Keys() : TM1638(8, 9, 7) {}
+  virtual uint32_t getButtons() { nReads++; return(dwKeys); }
+  uint32_t dwKeys=0;
+  unsigned long nReads=0;
+};
+
+static uint32_t dwSeed=1;
+
+static uint32_t random32()
+{
+  dwSeed=dwSeed*1103515245UL+12345;
+  uint32_t dwHigh=dwSeed>>16;
+  dwSeed=dwSeed*1103515245UL+12345;
+  return((dwHigh<<16) | (dwSeed>>16));
+}
+
+static void testDebounce(byte nSamples)
+{ // A key changes state after nSamples consecutive samples that differ from its debounced state.
+  // Keys bounce for a while after each change and also have single glitches.
+  TM1638Keys module;
+  TM16xxButtons buttons(&module);
+  buttons.setDebounce(nSamples, 1);     // a sample every msec
+  uint32_t dwStable=0, dwModel=0;
+  byte anBounce[32]={0};
+  byte anCount[32]={0};
+  long nMismatch=-1, nChanges=0;
+  for(long n=0; n<DEBOUNCE_STEPS; n++)
+  {
+    uint32_t r=random32();
+    if(r%16==0)
+    {
+      byte nKey=(r>>8)%32;
+      dwStable^=bit(nKey);
+      anBounce[nKey]=(r>>16)%24;
+    }
+    uint32_t dwBouncing=0;
+    for(byte nKey=0; nKey<32; nKey++)
+    {
+      if(anBounce[nKey])
+      {
+        anBounce[nKey]--;
+        dwBouncing|=bit(nKey);
+      }
+    }
+    uint32_t dwGlitch=random32() & random32() & random32() & random32();
+    module.dwKeys=dwStable ^ (random32() & dwBouncing) ^ dwGlitch;
+
+    // the model: a counter per key
+    for(byte nKey=0; nKey<32; nKey++)
+    {
+      if((module.dwKeys ^ dwModel) & bit(nKey))
+      {
+        if(++anCount[nKey]>=nSamples)
+        {
+          dwModel^=bit(nKey);
+          nChanges++;
+          anCount[nKey]=0;
+        }
+      }
+      else
+        anCount[nKey]=0;
+    }
+
+    simAdvance(1000);
+    uint32_t dwButtons=buttons.tick();
+    if(dwButtons!=dwModel && nMismatch<0)
+      nMismatch=n;
+  }
+  char szMsg[120];
+  snprintf(szMsg, sizeof(szMsg), "debounce %d samples equals the model (first difference at step %ld)", nSamples, nMismatch);
+  CHECK(nMismatch<0, szMsg);
+  snprintf(szMsg, sizeof(szMsg), "debounce %d samples reads the keys at every tick", nSamples);
+  CHECK(module.nReads==DEBOUNCE_STEPS, szMsg);
+  printf("  debounce %2d samples: %ld changes of the debounced keys\n", nSamples, nChanges);
+}
+
+static void step(TM1638Keys &module, TM16xxButtons &buttons, uint32_t dwKeys, unsigned int nMsec)
+{ // set the keys and tick every msec
+  module.dwKeys=dwKeys;
+  for(; nMsec; nMsec--)
+  {
+    simAdvance(1000);
+    buttons.tick();
+  }
+}
+
+static uint16_t now()
+{
+  return((uint16_t)millis());
+}
+
+static bool pollExpected(TM16xxButtons &buttons, const TM16xxButtonEvent &expected)
+{
+  TM16xxButtonEvent event;
+  return(buttons.pollEvent(event) && event.button==expected.button && event.event==expected.event && event.time==expected.time);
+}
+
+static void testQueueFull()
+{ // Before pollEvent() is called, a click is reported right after the release (no doubleclick callback).
+  // Five clicks give ten events, the last two don't fit.
+  TM1638Keys module;
+  TM16xxButtons buttons(&module);
+  std::vector<TM16xxButtonEvent> vExpected;
+  for(byte nButton=0; nButton<5; nButton++)
+  {
+    uint16_t tPress=now()+1;
+    step(module, buttons, bit(nButton), 50);
+    step(module, buttons, 0, 50);
+    vExpected.push_back(TM16xxButtonEvent{ nButton, TM16XX_BUTTONS_EVENT_RELEASE, (uint16_t)(tPress+50) });
+    vExpected.push_back(TM16xxButtonEvent{ nButton, TM16XX_BUTTONS_EVENT_CLICK, (uint16_t)(tPress+51) });
+  }
+  bool fOk=true;
+  for(byte n=0; n<TM16XX_BUTTONS_QUEUESIZE; n++)
+    fOk&=pollExpected(buttons, vExpected[n]);
+  CHECK(fOk, "queue: a full queue keeps the oldest events");
+  TM16xxButtonEvent event;
+  CHECK(!buttons.pollEvent(event), "queue: events are dropped when the queue is full");
+}
+
+static void testQueueLongPress()
+{ // the long press busy event of each tick is not queued
+  TM1638Keys module;
+  TM16xxButtons buttons(&module);
+  uint16_t tPress=now()+1;
+  step(module, buttons, bit(3), 2000);
+  step(module, buttons, 0, 10);
+  bool fOk=pollExpected(buttons, TM16xxButtonEvent{ 3, TM16XX_BUTTONS_EVENT_LONGPRESSSTART, (uint16_t)(tPress+1001) });
+  fOk&=pollExpected(buttons, TM16xxButtonEvent{ 3, TM16XX_BUTTONS_EVENT_RELEASE, (uint16_t)(tPress+2000) });
+  fOk&=pollExpected(buttons, TM16xxButtonEvent{ 3, TM16XX_BUTTONS_EVENT_LONGPRESSSTOP, (uint16_t)(tPress+2000) });
+  TM16xxButtonEvent event;
+  CHECK(fOk && !buttons.pollEvent(event), "queue: long press start, release and stop, no busy events");
+}
+
+static void testQueueWrap()
+{ // Rounds of 1-5 clicks, each followed by reading the queue. The byte indexes wrap around several times
+  // and rounds of 5 clicks drop events. Once pollEvent() was called, a click is reported after the click time.
+  TM1638Keys module;
+  TM16xxButtons buttons(&module);
+  TM16xxButtonEvent event;
+  buttons.pollEvent(event);
+  bool fOk=true;
+  unsigned long nEvents=0;
+  for(int nRound=0; nRound<QUEUE_ROUNDS; nRound++)
+  {
+    std::vector<TM16xxButtonEvent> vExpected;
+    for(byte n=0; n<=nRound%5; n++)
+    {
+      byte nButton=(nRound+n)%24;
+      uint16_t tPress=now()+1;
+      step(module, buttons, bit(nButton), 50);
+      step(module, buttons, 0, 600);
+      vExpected.push_back(TM16xxButtonEvent{ nButton, TM16XX_BUTTONS_EVENT_RELEASE, (uint16_t)(tPress+50) });
+      vExpected.push_back(TM16xxButtonEvent{ nButton, TM16XX_BUTTONS_EVENT_CLICK, (uint16_t)(tPress+501) });
+    }
+    if(vExpected.size()>TM16XX_BUTTONS_QUEUESIZE)
+      vExpected.resize(TM16XX_BUTTONS_QUEUESIZE);
+    for(const TM16xxButtonEvent &expected : vExpected)
+      fOk&=pollExpected(buttons, expected);
+    fOk&=!buttons.pollEvent(event);
+    nEvents+=vExpected.size();
+  }
+  CHECK(fOk, "queue: events in order after the indexes wrapped around");
+  CHECK(nEvents>2*256, "queue: the indexes wrapped around");
+}
+
+static void testQueueDoubleClick()
+{ // Two presses within the click time. Without pollEvent() and without doubleclick callback these are two clicks,
+  // once pollEvent() was called it is a double click.
+  for(byte nPolled=0; nPolled<2; nPolled++)
+  {
+    TM1638Keys module;
+    TM16xxButtons buttons(&module);
+    TM16xxButtonEvent event;
+    if(nPolled)
+      buttons.pollEvent(event);
+    uint16_t tPress=now()+1;
+    step(module, buttons, bit(5), 100);
+    step(module, buttons, 0, 100);
+    step(module, buttons, bit(5), 100);
+    step(module, buttons, 0, 600);
+    bool fOk=pollExpected(buttons, TM16xxButtonEvent{ 5, TM16XX_BUTTONS_EVENT_RELEASE, (uint16_t)(tPress+100) });
+    if(nPolled)
+    {
+      fOk&=pollExpected(buttons, TM16xxButtonEvent{ 5, TM16XX_BUTTONS_EVENT_RELEASE, (uint16_t)(tPress+300) });
+      fOk&=pollExpected(buttons, TM16xxButtonEvent{ 5, TM16XX_BUTTONS_EVENT_DOUBLECLICK, (uint16_t)(tPress+300) });
+    }
+    else
+    {
+      fOk&=pollExpected(buttons, TM16xxButtonEvent{ 5, TM16XX_BUTTONS_EVENT_CLICK, (uint16_t)(tPress+101) });
+      fOk&=pollExpected(buttons, TM16xxButtonEvent{ 5, TM16XX_BUTTONS_EVENT_RELEASE, (uint16_t)(tPress+300) });
+      fOk&=pollExpected(buttons, TM16xxButtonEvent{ 5, TM16XX_BUTTONS_EVENT_CLICK, (uint16_t)(tPress+301) });
+    }
+    fOk&=!buttons.pollEvent(event);
+    CHECK(fOk, nPolled ? "queue: double click once pollEvent() was called" : "queue: two clicks before pollEvent() was called");
+  }
+}
+
+static unsigned long readsPerSecond(TM1638Keys &module, TM16xxButtons &buttons, uint32_t dwKeys)
+{ // the reads of one second, after the keys were set for a while
+  step(module, buttons, dwKeys, 100);
+  module.nReads=0;
+  step(module, buttons, dwKeys, 1000);
+  return(module.nReads);
+}
+
+static void testScanInterval()
+{ // By default the keys are read at every tick. With setScanInterval() the TM1638 (no known key scan period)
+  // is read every 10 msec while a key is pressed and every 40 msec when idle.
+  TM1638Keys module;
+  TM16xxButtons buttons(&module);
+  unsigned long nIdle=readsPerSecond(module, buttons, 0);
+  unsigned long nHeld=readsPerSecond(module, buttons, bit(2));
+  printf("  scan default: %lu reads per idle second, %lu with a key held\n", nIdle, nHeld);
+  CHECK(nIdle==1000 && nHeld==1000, "scan: by default the keys are read at every tick");
+  step(module, buttons, 0, 2000);
+  buttons.setScanInterval();
+  nIdle=readsPerSecond(module, buttons, 0);
+  nHeld=readsPerSecond(module, buttons, bit(2));
+  printf("  scan (10, 40): %lu reads per idle second, %lu with a key held\n", nIdle, nHeld);
+  CHECK(nIdle==25, "scan: 25 reads per idle second");
+  CHECK(nHeld==100, "scan: 100 reads per second with a key held");
+}
+
+static void testRepeat()
+{ // setRepeat(500, 200, 4, 50): the interval becomes 4/16 shorter after each repeat, 200, 150, 113, 85, 64, then 50
+  static const uint16_t auExpected[]={ 500, 700, 850, 963, 1048, 1112, 1162, 1212, 1262 };
+  TM1638Keys module;
+  TM16xxButtons buttons(&module);
+  buttons.setRepeat(500, 200, 4, 50);
+  uint16_t tPress=now()+1;
+  module.dwKeys=bit(1);
+  byte nRepeats=0;
+  bool fOk=true;
+  for(int n=0; n<1300; n++)
+  {
+    simAdvance(1000);
+    buttons.tick();
+    TM16xxButtonEvent event;
+    while(buttons.pollEvent(event))
+    {
+      if(event.event!=TM16XX_BUTTONS_EVENT_REPEAT)
+        continue;
+      fOk&=(event.button==1 && nRepeats<sizeof(auExpected)/sizeof(auExpected[0]) && (uint16_t)(event.time-tPress)==auExpected[nRepeats]);
+      nRepeats++;
+    }
+  }
+  CHECK(fOk && nRepeats==sizeof(auExpected)/sizeof(auExpected[0]), "repeat: repeats at 500, 700, 850, 963 msec and so on, down to 50 msec");
+  step(module, buttons, 0, 1000);
+  TM16xxButtonEvent event;
+  while(buttons.pollEvent(event))
+    fOk&=(event.event!=TM16XX_BUTTONS_EVENT_REPEAT);
+  CHECK(fOk, "repeat: no repeats after the release");
+}
+
+static void testChord()
+{ // the chord S1+S8 fires once when both are pressed, again after S8 was released and pressed again
+  TM1638Keys module;
+  TM16xxButtons buttons(&module);
+  byte nChord=buttons.addChord(bit(0) | bit(7));
+  step(module, buttons, bit(0), 100);
+  step(module, buttons, bit(0) | bit(7), 200);
+  step(module, buttons, bit(0), 100);
+  step(module, buttons, bit(0) | bit(7), 200);
+  step(module, buttons, bit(7), 100);
+  step(module, buttons, 0, 1000);
+  byte nChords=0;
+  TM16xxButtonEvent event;
+  while(buttons.pollEvent(event))
+  {
+    if(event.event==TM16XX_BUTTONS_EVENT_CHORD && event.button==nChord)
+      nChords++;
+  }
+  CHECK(nChord==0 && nChords==2, "chord: fired once per match");
+}
+
+int main()
+{
+  for(byte nSamples=1; nSamples<=15; nSamples++)
+    testDebounce(nSamples);
+  testQueueFull();
+  testQueueLongPress();
+  testQueueWrap();
+  testQueueDoubleClick();
+  testScanInterval();
+  testRepeat();
+  testChord();
+
+  printf("test_buttons: %s\n", nFailed ? "FAILED" : "passed");
+  return(nFailed ? 1 : 0);
+}
@@ -0,0 +1,230 @@
+/*
+test_gfx.cpp - Host test of the byte-wise drawing methods of TM16xxMatrixGFX. See README.md
+
+Each drawing operation is done twice: on one matrix using the fast method, on an identical matrix pixel by pixel
+(the way Adafruit GFX draws it). The pixels of both matrices should be the same, for all rotations, with mirroring
+and with multiple modules.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#include <stdio.h>
+#include <vector>
+#include "sim.h"
+#include "TM1640.h"
+#include "TM16xxMatrixGFX.h"
+#include "TM16xxSprite.h"
+
+static int nFailed=0;
+static int nChecked=0;
+
+static bool samePixels(TM16xxMatrixGFX &a, TM16xxMatrixGFX &b)
+{
+  for(int16_t y=0; y<a.height(); y++)
+    for(int16_t x=0; x<a.width(); x++)
+      if(a.getPixel(x, y)!=b.getPixel(x, y))
+        return(false);
+  return(true);
+}
+
+static void check(TM16xxMatrixGFX &a, TM16xxMatrixGFX &b, const char *szWhat, byte nRotation)
+{
+  nChecked++;
+  if(!samePixels(a, b))
+  {
+    printf("FAIL: %s, rotation %d\n", szWhat, nRotation);
+    nFailed++;
+  }
+}
+
+static void testText(TM16xxMatrixGFX &fast, TM16xxMatrixGFX &ref, byte nRotation)
+{
+  const char *szText="Hello, TM16xx!\nLine 2";
+  for(int16_t x=-7; x<=fast.width(); x+=3)
+  {
+    for(int16_t y=-5; y<=fast.height(); y+=4)
+    {
+      for(byte nOpaque=0; nOpaque<2; nOpaque++)
+      {
+        fast.fillScreen(nOpaque);
+        ref.fillScreen(nOpaque);
+        fast.setTextColor(1-nOpaque, nOpaque ? 0 : 1-nOpaque);
+        ref.setTextColor(1-nOpaque, nOpaque ? 0 : 1-nOpaque);
+        fast.setCursor(x, y);
+        ref.setCursor(x, y);
+        for(const char *p=szText; *p; p++)
+        {
+          fast.write((uint8_t)*p);
+          ref.Adafruit_GFX::write((uint8_t)*p);   // drawn pixel by pixel
+        }
+      }
+      check(fast, ref, "write(uint8_t)", nRotation);
+    }
+  }
+}
+
+static void testRects(TM16xxMatrixGFX &fast, TM16xxMatrixGFX &ref, byte nRotation)
+{
+  for(int16_t x=-3; x<fast.width(); x+=5)
+  {
+    for(int16_t w=-4; w<=20; w+=3)
+    {
+      fast.fillScreen(0);
+      ref.fillScreen(0);
+      fast.fillRect(x, x/2, w, w/2+1, 1);
+      int16_t x0=(w<0 ? x+w+1 : x), w0=(w<0 ? -w : w), h0=w/2+1;
+      int16_t y0=(h0<0 ? x/2+h0+1 : x/2);
+      h0=(h0<0 ? -h0 : h0);
+      for(int16_t yy=y0; yy<y0+h0; yy++)
+        for(int16_t xx=x0; xx<x0+w0; xx++)
+          ref.drawPixel(xx, yy, 1);
+      check(fast, ref, "fillRect()", nRotation);
+    }
+  }
+}
+
+static void testBitmap(TM16xxMatrixGFX &fast, TM16xxMatrixGFX &ref, byte nRotation)
+{
+  static const uint8_t aBitmap[] PROGMEM={ 0xA5, 0x3C, 0x7E, 0x81, 0xFF, 0x00, 0x18, 0x99, 0x42, 0x24, 0xC3, 0x5A };
+  const int16_t w=12, h=8;      // 2 bytes per row, 4 bits of the second byte are used
+  for(int16_t x=-9; x<fast.width(); x+=4)
+  {
+    for(int16_t y=-5; y<fast.height(); y+=3)
+    {
+      fast.fillScreen(0);
+      ref.fillScreen(0);
+      fast.drawBitmap(x, y, aBitmap, w, h/2, 1);
+      for(int16_t j=0; j<h/2; j++)
+        for(int16_t i=0; i<w; i++)
+          if(pgm_read_byte(&aBitmap[j*2+i/8]) & (0x80>>(i&7)))
+            ref.drawPixel(x+i, y+j, 1);
+      check(fast, ref, "drawBitmap()", nRotation);
+    }
+  }
+}
+
+static void fillPattern(TM16xxMatrixGFX &matrix)
+{
+  for(int16_t y=0; y<matrix.height(); y++)
+    for(int16_t x=0; x<matrix.width(); x++)
+      matrix.drawPixel(x, y, (x*3+y)%5<2);
+}
+
+static void testBlit(TM16xxMatrixGFX &fast, TM16xxMatrixGFX &ref, byte nRotation)
+{ // a sprite of 10 columns of 12 rows with a mask, so it spans two blocks of 8x8 pixels in both directions
+  static const byte aData[]={ 0x81,0x00, 0x42,0x01, 0x24,0x02, 0x18,0x04, 0xFF,0x08, 0x00,0x0F, 0x3C,0x05, 0x66,0x0A, 0xC3,0x03, 0x5A,0x0C };
+  static const byte aMask[]={ 0xFF,0x03, 0xFF,0x07, 0x7E,0x0F, 0x3C,0x0F, 0xFF,0x0F, 0xF0,0x0F, 0xFF,0x0F, 0xFF,0x0E, 0xE7,0x07, 0xFF,0x0F };
+  TM16xxSprite sprite(aData, 10, 12, aMask, false);
+  const char *aszModes[]={ "blit() OR", "blit() COPY", "blit() XOR", "blit() CLEAR" };
+  for(int16_t x=-11; x<=fast.width(); x+=5)
+  {
+    for(int16_t y=-13; y<=fast.height(); y+=6)
+    {
+      for(byte nMode=TM16XX_BLIT_OR; nMode<=TM16XX_BLIT_CLEAR; nMode++)
+      {
+        fillPattern(fast);
+        fillPattern(ref);
+        fast.blit(x, y, sprite, nMode);
+        for(byte n=0; n<sprite.getWidth(); n++)
+        {
+          uint16_t uData=sprite.getColumn(n), uMask=sprite.getMask(n);
+          for(byte r=0; r<sprite.getHeight(); r++)
+          {
+            bool fSet=uData & bit(r);
+            if(fSet && nMode==TM16XX_BLIT_XOR)
+              ref.drawPixel(x+n, y+r, !ref.getPixel(x+n, y+r));
+            else if(fSet)
+              ref.drawPixel(x+n, y+r, nMode!=TM16XX_BLIT_CLEAR);
+            else if((uMask & bit(r)) && nMode==TM16XX_BLIT_COPY)
+              ref.drawPixel(x+n, y+r, 0);
+          }
+        }
+        check(fast, ref, aszModes[nMode], nRotation);
+      }
+    }
+  }
+}
+
+static void testMatrix(TM16xx *aFast[], TM16xx *aRef[], byte nColumns, byte nRows, byte nModulesCol, byte nModulesRow, bool fMirror)
+{
+  TM16xxMatrixGFX fast(aFast, nColumns, nRows, nModulesCol, nModulesRow);
+  TM16xxMatrixGFX ref(aRef, nColumns, nRows, nModulesCol, nModulesRow);
+  fast.setMirror(fMirror, false);
+  ref.setMirror(fMirror, false);
+  for(byte nRotation=0; nRotation<4; nRotation++)
+  {
+    fast.setRotation(nRotation);
+    ref.setRotation(nRotation);
+    testText(fast, ref, nRotation);
+    testRects(fast, ref, nRotation);
+    testBitmap(fast, ref, nRotation);
+    testBlit(fast, ref, nRotation);
+  }
+}
+
+static void testManyModules(byte nModulesCol, byte nModulesRow)
+{ // each pixel should have its own bit in memory, also without the translation tables (more than 16 modules per row
+  // or column) and without the module layout (more than 64 modules)
+  std::vector<TM1640> vChips(nModulesCol*nModulesRow, TM1640(2, 9));
+  TM16xx *aModules[255];
+  for(int n=0; n<nModulesCol*nModulesRow; n++)
+    aModules[n]=&vChips[n];
+  TM16xxMatrixGFX matrix(aModules, 8, 8, nModulesCol, nModulesRow);
+  for(byte nRotation=0; nRotation<4; nRotation+=3)
+  {
+    matrix.setRotation(nRotation);
+    matrix.fillScreen(0);
+    int nWrong=0;
+    for(int16_t y=0; y<matrix.height(); y++)
+    {
+      for(int16_t x=0; x<matrix.width(); x++)
+      {
+        if(matrix.getPixel(x, y))
+          nWrong++;       // set by another pixel that uses the same bit
+        matrix.drawPixel(x, y, 1);
+        matrix.drawFastHLine(x, y, 1, 1);    // using writeBits()
+      }
+    }
+    nChecked++;
+    if(nWrong)
+    {
+      printf("FAIL: %dx%d modules, rotation %d, %d pixels share memory\n", nModulesRow, nModulesCol, nRotation, nWrong);
+      nFailed++;
+    }
+  }
+}
+
+static void testBufferedModules()
+{ // write() sends the changes of unbuffered modules, but leaves a module that the sketch made buffered as it was
+  TM1640 m1(2, 9), m2(3, 9);
+  TM16xx *aModules[]={&m1, &m2};
+  TM16xxMatrixGFX matrix(aModules, 8, 8, 1, 2);
+  m2.setBuffered(true);
+  matrix.fillScreen(1);
+  matrix.write();
+  nChecked++;
+  if(m1.isBuffered() || m1.hasPendingData() || !m2.isBuffered() || !m2.hasPendingData())
+  {
+    printf("FAIL: write() changed the buffered mode of a module\n");
+    nFailed++;
+  }
+}
+
+int main()
+{
+  TM1640 f1(2, 9), f2(3, 9), f3(4, 9), f4(5, 9);
+  TM1640 r1(2, 9), r2(3, 9), r3(4, 9), r4(5, 9);
+  TM16xx *aFast[]={&f1, &f2, &f3, &f4};
+  TM16xx *aRef[]={&r1, &r2, &r3, &r4};
+
+  testMatrix(aFast, aRef, 16, 8, 1, 1, false);    // single TM1640 16x8
+  testMatrix(aFast, aRef, 16, 8, 1, 1, true);
+  testMatrix(aFast, aRef, 8, 8, 2, 2, false);     // four 8x8 modules in a square
+  testManyModules(1, 20);     // 20 modules in a row
+  testManyModules(20, 1);     // 20 modules in a column
+  testManyModules(7, 10);     // 70 modules
+  testBufferedModules();
+
+  printf("test_gfx: %d checks, %s\n", nChecked, nFailed ? "FAILED" : "passed");
+  return(nFailed ? 1 : 0);
+}
@@ -0,0 +1,143 @@
+/*
+test_grayscale.cpp - Host test of the plane weights of TM16xxMatrixGFX::serviceGrayscale(). See README.md
+
+A recording TM1640 keeps the display RAM that the chip would have, using the bytes sent to it. The test calls
+serviceGrayscale() while advancing the simulated time of micros() and adds up the time each pixel is on. Sending a
+byte also takes time, like on a real MCU. The duty cycle of each pixel should be its level divided by the maximum level.
+In timer mode (plane time 0) the calls of serviceGrayscale() are counted instead.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include "sim.h"
+#include "TM1640.h"
+#include "TM16xxMatrixGFX.h"
+
+#define SEND_MICROS 20      // time to send a byte
+
+static int nFailed=0;
+
+#define CHECK(cond, msg) do { if(!(cond)) { printf("FAIL: %s\n", msg); nFailed++; } } while(0)
+
+class TM1640Recording : public TM1640
+{ // TM1640 that keeps the display RAM of the chip and the time each LED was on
+  public:
+    TM1640Recording() : TM1640(8, 9) {}
+
+    byte ram[16];
+    unsigned long aOnTime[16][8];
+    unsigned long uTotalTime=0;
+
+    void reset()
+    {
+      account();
+      memset(aOnTime, 0, sizeof(aOnTime));
+      uTotalTime=0;
+    }
+
+    void account()
+    { // add the time since the last change to the on-time of the LEDs that are on
+      unsigned long tNow=micros();
+      for(byte nAddress=0; nAddress<16; nAddress++)
+        for(byte nBit=0; nBit<8; nBit++)
+          if(ram[nAddress] & bit(nBit))
+            aOnTime[nAddress][nBit]+=tNow-_tLast;
+      uTotalTime+=tNow-_tLast;
+      _tLast=tNow;
+    }
+
+  protected:
+    virtual void start() { _frame.clear(); }
+    virtual void stop()
+    { // apply an address command followed by data (auto increment addressing)
+      if(_frame.size()>1 && (_frame[0] & 0xC0)==TM16XX_CMD_ADDRESS)
+      {
+        account();
+        for(size_t n=1; n<_frame.size(); n++)
+          ram[((_frame[0] & 0x0F)+n-1) & 0x0F]=_frame[n];
+      }
+    }
+    virtual void send(byte data)
+    {
+      _frame.push_back(data);
+      simAdvance(SEND_MICROS);
+    }
+
+  private:
+    SimFrame _frame;
+    unsigned long _tLast=0;
+};
+
+int main()
+{
+  TM1640Recording module;
+  memset(module.ram, 0, sizeof(module.ram));
+  TM16xxMatrixGFX matrix(&module, 16, 8);
+  module.begin();
+
+  // find the LED of each test pixel in monochrome mode
+  const byte nPixels=16;
+  byte aAddress[nPixels], aBit[nPixels];
+  for(byte n=0; n<nPixels; n++)
+  {
+    matrix.fillScreen(0);
+    matrix.drawPixel(n%8, n, 1);
+    matrix.write();
+    aAddress[n]=0xFF;
+    for(byte nAddress=0; nAddress<16; nAddress++)
+      for(byte nBit=0; nBit<8; nBit++)
+        if(module.ram[nAddress] & bit(nBit))
+          aAddress[n]=nAddress, aBit[n]=nBit;
+    CHECK(aAddress[n]!=0xFF, "pixel found in display RAM");
+  }
+
+  for(byte nBits=2; nBits<=TM16XX_GRAYSCALE_MAXBITS; nBits++)
+  {
+    byte nMax=bit(nBits)-1;
+    CHECK(matrix.setGrayscale(nBits, 500), "setGrayscale()");
+    for(byte n=0; n<nPixels; n++)
+      matrix.drawPixel(n%8, n, n%(nMax+1));
+    matrix.serviceGrayscale();
+    module.reset();
+    for(unsigned long t=0; t<2000000UL; t+=37)
+    { // call at irregular intervals, like loop() would
+      matrix.serviceGrayscale();
+      simAdvance(37);
+    }
+    module.account();
+    double dMaxError=0;
+    for(byte n=0; n<nPixels; n++)
+    {
+      double dDuty=(double)module.aOnTime[aAddress[n]][aBit[n]]/module.uTotalTime;
+      double dExpected=(double)(n%(nMax+1))/nMax;
+      dMaxError=fmax(dMaxError, fabs(dDuty-dExpected));
+    }
+    printf("test_grayscale: %d bits, 500us per plane, max duty error %.4f\n", nBits, dMaxError);
+    CHECK(dMaxError<0.01, "duty cycle of each level");
+  }
+
+  // timer mode: count the calls
+  const byte nBits=3;
+  CHECK(matrix.setGrayscale(nBits, 0), "setGrayscale() in timer mode");
+  for(byte n=0; n<nPixels; n++)
+    matrix.drawPixel(n%8, n, n%8);
+  unsigned long aCount[nPixels]={0};
+  const unsigned long nCalls=7*1000;
+  for(unsigned long nCall=0; nCall<nCalls; nCall++)
+  {
+    matrix.serviceGrayscale();
+    for(byte n=0; n<nPixels; n++)
+      if(module.ram[aAddress[n]] & bit(aBit[n]))
+        aCount[n]++;
+  }
+  bool fCountOk=true;
+  for(byte n=0; n<nPixels; n++)
+    fCountOk&=(aCount[n]==(n%8)*nCalls/7);
+  printf("test_grayscale: %d bits, timer mode, %s\n", nBits, fCountOk ? "exact counts" : "wrong counts");
+  CHECK(fCountOk, "calls per level in timer mode");
+
+  printf("test_grayscale: %s\n", nFailed ? "FAILED" : "passed");
+  return(nFailed ? 1 : 0);
+}
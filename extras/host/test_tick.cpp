@@ -0,0 +1,114 @@
+/*
+test_tick.cpp - Host test of the background refresh of TM16xx::tick(). See README.md
+
+The display data is sent once using flush() and once using tick(), while the sketch interrupts the background refresh
+with transactions of its own (reading buttons and setting the display). These call tickHold() and tickRelease() via
+start() and stop(). The display RAM of the simulated chip must end up the same, each frame on the wire must be complete
+and the buttons must be read correctly.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#include <stdio.h>
+#include "sim.h"
+#include "TM1638.h"
+
+#define DIO 8
+#define CLK 9
+#define STB 7
+
+static int nFailed=0;
+
+#define CHECK(cond, msg) do { if(!(cond)) { printf("FAIL: %s\n", msg); nFailed++; } } while(0)
+
+static void setFrame(TM1638 &module, byte nFrame)
+{ // change a few digits, leaving gaps so the data is sent in multiple runs
+  module.setSegments(0x10+nFrame, 0);
+  module.setSegments(0x20+nFrame, 1);
+  module.setSegments(0x30+nFrame, 2);
+  module.setSegments(0x50+nFrame, 5);
+  module.setSegments(0x70+nFrame, 7);
+}
+
+static bool framesComplete()
+{ // every frame should be a single command, an address with data, or a read command with 4 key bytes
+  // (when the sketch interrupts a run right after the address, that frame has no data; it is sent again later)
+  for(size_t n=0; n<simFrames.size(); n++)
+  {
+    const SimFrame &frame=simFrames[n];
+    if(frame.empty())
+      return(false);
+    if(frame[0]==0x42 && frame.size()!=1+SIM_KEY_BYTES)
+      return(false);
+    if((frame[0] & 0xC0)!=0xC0 && frame[0]!=0x42 && frame.size()!=1)
+      return(false);
+  }
+  return(true);
+}
+
+int main()
+{
+  byte aExpected[SIM_RAM_SIZE];
+
+  // reference: send the data using flush()
+  simAttach(DIO, CLK, STB);
+  TM1638 module(DIO, CLK, STB);
+  module.begin(true, 2);
+  module.setBuffered(true);
+  for(byte nFrame=0; nFrame<4; nFrame++)
+  {
+    setFrame(module, nFrame);
+    module.flush();
+  }
+  memcpy(aExpected, simRam, sizeof(aExpected));
+  simKeys[0]=0x11;    // S1 and S5 (K3/KS1 and K3/KS2)
+  simKeys[2]=0x01;    // S3
+  uint32_t dwExpectedButtons=module.getButtons();
+  CHECK(dwExpectedButtons!=0, "reference reading of buttons");
+
+  // background refresh, interrupted by the sketch in between the ticks
+  simAttach(DIO, CLK, STB);
+  TM1638 moduleTick(DIO, CLK, STB);
+  moduleTick.begin(true, 2);
+  moduleTick.setBuffered(true);
+  simKeys[0]=0x11;
+  simKeys[2]=0x01;
+  unsigned long nTicks=0;
+  bool fButtonsOk=true;
+  for(byte nFrame=0; nFrame<4; nFrame++)
+  {
+    setFrame(moduleTick, nFrame);
+    for(byte n=0; moduleTick.tick(); n++)
+    {
+      nTicks++;
+      // a transaction of the sketch ends the current run, so give tick() a few calls to make progress
+      if(n%8==3)
+        fButtonsOk&=(moduleTick.getButtons()==dwExpectedButtons);
+      else if(n%8==6)
+        moduleTick.setupDisplay(true, 2);
+      else if(n==5)
+        setFrame(moduleTick, nFrame+0x08);    // change data while a run may be halfway
+      CHECK(simInterruptsEnabled, "interrupts enabled after a transaction");
+      CHECK(nTicks<1000, "tick() finishes");
+      if(nTicks>=1000)
+        break;
+    }
+    if(nFrame>=1)
+      setFrame(moduleTick, nFrame);    // final data of this frame, also the expected data when n==5 was reached
+    while(moduleTick.tick())
+      ;
+  }
+
+  CHECK(fButtonsOk, "buttons read between ticks");
+  CHECK(framesComplete(), "frames on the wire are complete");
+  CHECK(memcmp(simRam, aExpected, sizeof(aExpected))==0, "display RAM after tick() equals display RAM after flush()");
+  CHECK(!moduleTick.hasPendingData(), "no pending data after tick() returned false");
+  if(memcmp(simRam, aExpected, sizeof(aExpected)))
+  {
+    for(byte n=0; n<SIM_RAM_SIZE; n++)
+      printf("  %2d: %02X %02X\n", n, aExpected[n], simRam[n]);
+  }
+
+  printf("test_tick: %lu ticks, %s\n", nTicks, nFailed ? "FAILED" : "passed");
+  return(nFailed ? 1 : 0);
+}
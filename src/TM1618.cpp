@@ -49,6 +49,7 @@ void TM1618::setupDisplay(bool active, byte intensity)
 
   // Switch display on/off and set intensity 
   sendCommand(TM16XX_CMD_DISPLAY | (active ? 8 : 0) | min(7, intensity));
+  levelSetup(active, intensity);
 }
 
 void TM1618::setSegments(byte segments, byte position)
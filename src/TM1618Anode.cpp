@@ -43,6 +43,7 @@ void TM1618Anode::setupDisplay(bool active, byte intensity)
 
   // Switch display on/off and set intensity 
   sendCommand(TM16XX_CMD_DISPLAY | (active ? 8 : 0) | min(7, intensity));
+  levelSetup(active, intensity);
 }
 
 void TM1618Anode::setSegmentMap(const byte aMap[])
@@ -65,13 +65,92 @@ void TM1621::sendCommand(byte cmd)
   stop();
 }
 
+void TM1621::nibbleWrite(byte address, byte data)
+{ // Update an address in the copy of the display memory and mark it as changed. Unchanged data is skipped.
+  if(address>=TM1621_RAM_SIZE)
+    return;
+  data&=0x0F;
+  if(_fNibblesValid && nibbleRead(address)==data)
+  {
+#if(TM16XX_OPT_SHADOWRAM)
+    _dwWritesSuppressed++;
+#endif
+    return;
+  }
+  byte nShift=(address&1)<<2;
+  _btNibbles[address>>1]=(_btNibbles[address>>1] & ~(0x0F<<nShift)) | (data<<nShift);
+  _btNibbleDirty[address>>3]|=bit(address&7);
+}
+
 void TM1621::sendData(byte address, byte data)
-{ // send the data using fixed addressing mode: 0b101aaaaaadddd0 (6-bit address a5-a0, 4-bit data d0-d3)
-  uint16_t uFullData=((0x0500 | (address<<2)) << 5) | ((data&0x0f)<<3);  // address+data
+{ // The data is written to the copy of the display memory. Changed data is sent by service(), using continuous write mode.
+  // Compared to fixed addressing (0b101aaaaaadddd per address), successive addresses only need 4 bits each.
   begin();    // begin() is implicitly called upon first sending of display data, but executes only once.
-	start();
-  sendBits(uFullData, 13);
-  stop();
+  nibbleWrite(address, data);
+  if(_fNibbleHold)
+    return;   // will be sent by releaseNibbles()
+#if(TM16XX_OPT_SHADOWRAM)
+  if(_fBuffered)
+    return;   // will be sent by flush()
+#endif
+  flush();
+}
+
+void TM1621::releaseNibbles()
+{ // Send the addresses written while _fNibbleHold was set, e.g. all four addresses of an alphanumeric digit
+  _fNibbleHold=false;
+#if(TM16XX_OPT_SHADOWRAM)
+  if(_fBuffered)
+    return;
+#endif
+  flush();
+}
+
+bool TM1621::service(byte nMaxBytes, uint16_t uMaxMicros)
+{ // Send the changed addresses using continuous write mode: 0b101aaaaaa (6-bit start address a5-a0) followed by
+  // 4-bit data d0-d3 for each successive address. Each run of changed addresses is sent using one header.
+  // Up to TM1621_GAP_NIBBLES unchanged addresses within a run are resent, as that is cheaper than a new header.
+  // Limits are checked per address, similar to TM16xx::service(). Two addresses count as one byte.
+  fadeStep();
+  byte nRamSize=__min(_ctrl.grid_len, TM1621_RAM_SIZE);
+  uint32_t tStart=micros();
+  byte nSent=0;
+  byte nAddress=0;
+  while(true)
+  {
+    while(nAddress<nRamSize && !nibbleDirty(nAddress))
+      nAddress++;
+    if(nAddress>=nRamSize)
+      return(true);   // all sent
+    byte nLast=nAddress;
+    for(byte n=nAddress+1; n<nRamSize && n<=nLast+TM1621_GAP_NIBBLES+1; n++)
+      if(nibbleDirty(n)) nLast=n;   // extend the run
+    if(nSent && serviceSpent(nSent/2+1, nMaxBytes, tStart, uMaxMicros))
+      return(false);
+    start();
+    sendBits((0x0500 | (nAddress<<2)) << 5, 9);   // mode + start address
+    for(; nAddress<=nLast; nAddress++)
+    {
+      if(nSent && serviceSpent(nSent/2+1, nMaxBytes, tStart, uMaxMicros))
+        break;
+      sendBits(nibbleRead(nAddress)<<12, 4);     // data d0-d3, the address increments automatically
+      _btNibbleDirty[nAddress>>3]&=~bit(nAddress&7);
+      nSent++;
+#if(TM16XX_OPT_SHADOWRAM)
+      _dwWritesPerformed++;
+#endif
+    }
+    stop();
+    if(nAddress<=nLast)
+      return(false);   // continue at the next call
+  }
+}
+
+bool TM1621::hasPendingData()
+{
+  for(byte n=0; n<TM1621_RAM_SIZE/8; n++)
+    if(_btNibbleDirty[n]) return(true);
+  return(false);
 }
 
 void TM1621::setupDisplay(bool active, byte intensity)
@@ -91,6 +170,24 @@ void TM1621::setupDisplay(bool active, byte intensity)
     sendCommand(TM1621_LCD_OFF);
     sendCommand(TM1621_SYS_DIS);
   }
+  levelSetup(active, intensity);
+}
+
+byte TM1621::getLevels()
+{ // The LCD has no intensity levels, fading to level 0 switches it off
+  return(1);
+}
+
+void TM1621::setLevel(byte nLevel)
+{ // Switch the LCD on or off, keeping the bias as set by setupDisplay()
+  if(nLevel)
+  {
+    sendCommand(TM1621_SYS_EN);
+    sendCommand(TM1621_LCD_ON);
+  }
+  else
+    sendCommand(TM1621_LCD_OFF);
+  _nLevel=(nLevel ? 1 : 0);
 }
 
 void TM1621::clearDisplay(bool fOff)
@@ -98,8 +195,14 @@ void TM1621::clearDisplay(bool fOff)
     // Clear the display; TM1621 has 32 addresses for SEG0-SEG31; TM1621D has 23 addresses but only uses SEG9-SEG22;
     // TM1621B seems same as TM1621; TM1621C has 31 addresses but only uses SEG0-SEG5, SEG13-SEG19, SEG26-30;
     // TM1622 has a similar memory layout with 4-bits per address, with COM0-COM3 on even addresses and COM4-COM7 on odd addresses
-    for(int i=0; i<_ctrl.grid_len; i++)
-      sendData(i, fOff?0:0xFF);
+    // All addresses are sent using a single continuous write.
+    begin();    // begin() is implicitly called upon first sending of display data, but executes only once.
+    byte nRamSize=__min(_ctrl.grid_len, TM1621_RAM_SIZE);
+    memset(_btNibbles, fOff?0:0xFF, TM1621_RAM_SIZE/2);
+    for(byte i=0; i<nRamSize; i++)
+      _btNibbleDirty[i>>3]|=bit(i&7);
+    _fNibblesValid=true;      // the display memory will match the copy
+    flush();
 }
 
 void TM1621::setSegments16(uint16_t segments, byte position)
@@ -166,6 +269,7 @@ Bar-3 on seg 3 of position 10
   // Map segments if specified for alternative segment wiring.
   if(pSegmentMap)
     segments=mapSegments16(segments, pSegmentMap);
+  _fNibbleHold=true;    // send all addresses of this digit using a single header
 
   // conversion of regular TM16xx segments/position to TM1621 LCD segments/common
   if(this->_layout==TM1621D_LAYOUT_4C2S_0CBA_DEGF)
@@ -199,4 +303,5 @@ Bar-3 on seg 3 of position 10
     sendData((position<<1), segments & 0x0F);     // SEGx+1: segments ABCD on first address (S0)
     sendData(((position<<1)|1), (segments&0xF0)>>4);      // SEGx+0: segments EFGP on second address (S1)
   }
+  releaseNibbles();
 }
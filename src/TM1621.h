@@ -26,6 +26,11 @@ References:
 
 //#define TM1621_PULSE_WIDTH   10    // microseconds (Sonoff = 100)
 
+// The display memory is kept in a copy of 4-bit addresses (nibbles). Changed data is sent using continuous write mode:
+// one header (mode 101 + 6-bit start address) followed by the data of successive addresses.
+#define TM1621_RAM_SIZE 64         // TM1622 has 64 4-bit addresses, TM1621 has 32
+#define TM1621_GAP_NIBBLES 2       // resending up to 2 unchanged addresses is cheaper than a new header (9 bits + start/stop)
+
 // TM1621 COMMANDS
 #define TM1621_SYS_DIS       0x00  // 0b00000000
 #define TM1621_SYS_EN        0x01  // 0b00000001
@@ -72,6 +77,8 @@ class TM1621 : public TM16xxIC
    /** Set the LCD display active or inactive. Intensity level 2 or 3 can be used for selecting bias 1/2 or 1/3.
    Note that usually a potmeter is connected to the VLCD pin to tune the contrast level. */
     void setupDisplay(bool active, byte intensity=2);
+    virtual byte getLevels();
+    virtual void setLevel(byte nLevel);   // on/off only
 
     /** Clear the display */
     virtual void clearDisplay(bool fOff=true);
@@ -80,17 +87,32 @@ class TM1621 : public TM16xxIC
     //virtual void setSegments(byte segments, byte position);
     virtual void setSegments16(uint16_t segments, byte position);
 
+    // Changed data is sent using continuous write mode. In buffered mode flush() or service() sends all changes at once.
+    virtual bool service(byte nMaxBytes=TM16XX_SERVICE_BYTES, uint16_t uMaxMicros=0);
+    virtual bool hasPendingData();
+#if(TM16XX_OPT_BACKGROUND)
+    virtual bool tick() { return(false); }   // background refresh is not supported, use service() instead
+#endif
+
   protected:
     virtual void start();
     virtual void stop();
     virtual void send(byte data);
     virtual void sendCommand(byte cmd);
     virtual void sendData(byte address, byte data);
+    void releaseNibbles();   // end of _fNibbleHold: send the data held back by sendData()
     byte _layout=0;      // display layout of LCD segments/digits
     uint16_t _uDots=0;   // some memory to remember the setting of dots (modules may have them on separate addresses, eg. DM8BA10 10x16-segment LCD module)
+    bool _fNibbleHold=false;   // set while writing a digit, so its addresses are sent using a single header
 
   private:
     void sendBits(uint16_t uFullData, byte nNumBits);
+    void nibbleWrite(byte address, byte data);
+    byte nibbleRead(byte address) { return((_btNibbles[address>>1]>>((address&1)<<2))&0x0F); }
+    bool nibbleDirty(byte address) { return(_btNibbleDirty[address>>3]&bit(address&7)); }
+    byte _btNibbles[TM1621_RAM_SIZE/2]={0};      // copy of the display memory, two 4-bit addresses per byte
+    byte _btNibbleDirty[TM1621_RAM_SIZE/8]={0};  // bit per address: changed, but not yet sent
+    bool _fNibblesValid=false;   // the copy matches the display memory (after clearDisplay())
 };
 
 class TM1621D : public TM1621
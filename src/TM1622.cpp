@@ -18,8 +18,10 @@ void TM1622::setSegments16(uint16_t segments, byte position)
     segments=mapSegments16(segments, pSegmentMap);
   
   // assume 8-COM, 1-SEG layout by default: TM1622_LAYOUT_8C1S_PGFE_DCBA
+  _fNibbleHold=true;    // send both addresses using a single header
   sendData((position<<1), segments & 0x0F);     // SEGx+1: segments ABCD on first address (S0/COM0-COM3)
   sendData(((position<<1)|1), (segments&0xF0)>>4);      // SEGx+0: segments EFGP on second address (S0/COM4-COM7)
+  releaseNibbles();
 }
 
 void TM1622_DM8BA10::setSegments16(uint16_t segments, byte position)
@@ -27,6 +29,7 @@ void TM1622_DM8BA10::setSegments16(uint16_t segments, byte position)
   // Map segments if specified for alternative segment wiring.
   if(pSegmentMap)
     segments=mapSegments16(segments, pSegmentMap);
+  _fNibbleHold=true;    // send the addresses of this digit using a single header (the dots use a second one)
 
   // conversion of regular TM16xx segments/position to TM1622 LCD segments/common
   if(this->_layout==TM1622_LAYOUT_DM8BA10)
@@ -61,5 +64,6 @@ void TM1622_DM8BA10::setSegments16(uint16_t segments, byte position)
     sendData((position<<1), segments & 0x0F);     // SEGx+1: segments ABCD on first address (S0/COM0-COM3)
     sendData(((position<<1)|1), (segments&0xF0)>>4);      // SEGx+0: segments EFGP on second address (S0/COM4-COM7)
   }
+  releaseNibbles();
 }
 
@@ -40,12 +40,13 @@ void TM1637::bitDelay()
 
 void TM1637::stop()
 { // to stop TM1637 expects the clock to go high, when strobing DIO high
-  digitalWrite(strobePin, LOW);
-  digitalWrite(clockPin, LOW);
+  strobeWrite(LOW);
+  clockWrite(LOW);
   bitDelay();
-  digitalWrite(clockPin, HIGH);
-  digitalWrite(strobePin, HIGH);
+  clockWrite(HIGH);
+  strobeWrite(HIGH);
   bitDelay();
+  tickRelease();
 }
 
 void TM1637::send(byte data)
@@ -57,14 +58,14 @@ void TM1637::send(byte data)
   // unlike TM1638/TM1668 and TM1640, the TM1637 uses an ACK to confirm reception of command/data
   // read the acknowledgement
   // TODO? return the ack?
-  digitalWrite(clockPin, LOW);
+  clockWrite(LOW);
   pinMode(dataPin, INPUT);
   bitDelay();
-  digitalWrite(clockPin, HIGH);
+  clockWrite(HIGH);
   bitDelay();
-  uint8_t ack = digitalRead(dataPin);
+  uint8_t ack = dataRead();
   if (ack == 0)
-    digitalWrite(dataPin, LOW);
+    dataWrite(LOW);
   pinMode(dataPin, OUTPUT);
 }
 
@@ -35,6 +35,10 @@ class TM1637 : public TM16xx
     virtual void bitDelay();
     virtual void stop();
     virtual void send(byte data);
+#if(TM16XX_OPT_SPI)
+    using TM16xx::setSPI;   // hardware SPI is only supported by 3-wire chips
+    virtual bool canUseSPI() { return(false); }
+#endif
     //uint16_t _uLeds;		// rooom to store status of LEDS that can be attached to GRD 5 and 6
 };
 
@@ -42,24 +42,26 @@ void TM1640::bitDelay()
 void TM1640::start()
 { // if needed derived classes can use different patterns to start a command (eg. for TM1637)
   // Datasheet: The starting condition of data input is: when CLK is high, the DIN becomes low from high;
-  digitalWrite(dataPin, LOW);
-  digitalWrite(clockPin, LOW);
+  tickHold();
+  dataWrite(LOW);
+  clockWrite(LOW);
   bitDelay();
 }
 
 void TM1640::stop()
 { // if needed derived classes can use different patterns to stop a command (eg. for TM1637)
   // datasheet: the ending condition is: when CLK is high, the DIN becomes high from low.
-  digitalWrite(clockPin, HIGH);
-  digitalWrite(dataPin, HIGH);
+  clockWrite(HIGH);
+  dataWrite(HIGH);
   bitDelay();
+  tickRelease();
 }
 
 void TM1640::send(byte data)
 {
   // MOLE 180514: TM1640 wants data and clock to be low after sending the data
   TM16xx::send(data);
-  digitalWrite(clockPin, LOW);    // first clock low
-  digitalWrite(dataPin, LOW);     // then data low
+  clockWrite(LOW);    // first clock low
+  dataWrite(LOW);     // then data low
   bitDelay();
 }
@@ -36,6 +36,10 @@ class TM1640 : public TM16xx
     virtual void start();
     virtual void stop();
     virtual void send(byte data);
+#if(TM16XX_OPT_SPI)
+    using TM16xx::setSPI;   // hardware SPI is only supported by 3-wire chips
+    virtual bool canUseSPI() { return(false); }
+#endif
 };
 
 #endif
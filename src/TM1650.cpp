@@ -42,11 +42,11 @@ void TM1650::start()
 {	// if needed derived classes can use different patterns to start a command (eg. for TM1637)
 	// Datasheet p.3: "Start signal: keep SCL at "1" level, SDA jumps from "1" to "0", which is considered to be the start signal."
 	// TM1650 expects start and stop like I2C: at start data is low, then clock changes from high to low.
-  digitalWrite(dataPin, HIGH);
-  digitalWrite(clockPin, HIGH);
+  dataWrite(HIGH);
+  clockWrite(HIGH);
   bitDelay();
-  digitalWrite(dataPin, LOW);
-  digitalWrite(clockPin, LOW);
+  dataWrite(LOW);
+  clockWrite(LOW);
 	bitDelay();
 
 }
@@ -55,11 +55,11 @@ void TM1650::stop()
 { // to stop TM1650 expects the clock to go high, when strobing DIO high
 	// Datasheet p.3: "End signal: keep SCL at "1" level, SDA jumps from "0" to "1", which is considered to be the end signal."
 	// TM1650 expects start and stop like I2C: at stop clock is high, then data changes from low to high.
-  digitalWrite(clockPin, LOW);
-  digitalWrite(dataPin, LOW);
+  clockWrite(LOW);
+  dataWrite(LOW);
 	bitDelay();
-  digitalWrite(clockPin, HIGH);
-  digitalWrite(dataPin, HIGH);
+  clockWrite(HIGH);
+  dataWrite(HIGH);
 	bitDelay();
 }
 
@@ -69,13 +69,13 @@ void TM1650::send(byte data)
 
   for (int i = 0; i < 8; i++)
   {
-    digitalWrite(clockPin, LOW);
+    clockWrite(LOW);
     bitDelay();
 
-    digitalWrite(dataPin, data & 0x80 ? HIGH : LOW);		// in contrast to other TM16xx chips, the TM1650 expects MSB first
+    dataWrite(data & 0x80 ? HIGH : LOW);		// in contrast to other TM16xx chips, the TM1650 expects MSB first
     data <<= 1;
 
-    digitalWrite(clockPin, HIGH);
+    clockWrite(HIGH);
     bitDelay();
   }
   bitDelay();
@@ -85,26 +85,57 @@ void TM1650::send(byte data)
   // read the acknowledgement
   // TODO? return the ack?
 	// (method derived from https://github.com/avishorp/TM1637 but using pins in standard output mode when writing)
-  digitalWrite(clockPin, LOW);
+  clockWrite(LOW);
   pinMode(dataPin, INPUT);
   bitDelay();
-  digitalWrite(clockPin, HIGH);
+  clockWrite(HIGH);
   bitDelay();
-  uint8_t ack = digitalRead(dataPin);
+  uint8_t ack = dataRead();
   if (ack == 0)
-	  digitalWrite(dataPin, LOW);
+	  dataWrite(LOW);
   pinMode(dataPin, OUTPUT);
 }
 
 void TM1650::sendData(byte address, byte data)
 {	// TM1650 uses different commands than most other TM16XX chips
   begin();    // begin() is implicitly called upon first sending of display data, but only executes once.
+  if(!shadowWrite(address, data))
+    return;   // data is unchanged or will be sent by flush()
 	start();
   send(TM1650_CMD_ADDRESS | address<<1);						// address command + address (68,6A,6C,6E)
   send(data);
   stop();
 }
 
+bool TM1650::service(byte nMaxBytes, uint16_t uMaxMicros)
+{ // Send the buffered display data that was changed, within the limits of this call (see TM16xx::service()).
+  // The TM1650 has no auto-increment addressing, so every changed byte is sent using its own address command.
+  fadeStep();
+#if(TM16XX_OPT_SHADOWRAM)
+  uint32_t tStart=micros();
+  byte nSent=0;
+  _uShadowDirty&=bit(_maxDisplays)-1;
+  for(byte nAddress=0; _uShadowDirty && nAddress<_maxDisplays; nAddress++)
+  {
+    if(_uShadowDirty & bit(nAddress))
+    {
+      if(nSent && serviceSpent(nSent+1, nMaxBytes, tStart, uMaxMicros))
+        break;
+      nSent++;
+      _uShadowDirty&=~bit(nAddress);
+      _dwWritesPerformed++;
+      start();
+      send(TM1650_CMD_ADDRESS | nAddress<<1);
+      send(_btShadowRam[nAddress]);
+      stop();
+    }
+  }
+  return(_uShadowDirty==0);
+#else
+  return(true);
+#endif
+}
+
 void TM1650::clearDisplay()
 {	// Clear all data registers. The number of registers depends on the chip.
 	// TM1638 (10x8): 10 segments per grid, stored in two bytes. The first byte contains the first 8 display segments, second byte has seg9+seg10  => 16 bytes
@@ -127,6 +158,12 @@ void TM1650::setupDisplay(bool active, byte intensity)
   send(TM1650_CMD_MODE);
   send( (intensity<<4) | (_maxSegments==7? 0x08:0x00) | (active?0x01:0x00));
   stop();
+  levelSetup(active, intensity==0 ? 7 : intensity-1);
+}
+
+void TM1650::setLevel(byte nLevel)
+{ // The TM1650 sets the intensity and the display mode in one command
+  setupDisplay(nLevel!=0, nLevel ? nLevel-1 : 0);
 }
 
 byte TM1650::receive()
@@ -134,44 +171,49 @@ byte TM1650::receive()
   byte temp = 0;
 
   // Pull-up on
-  digitalWrite(clockPin, LOW);
+  clockWrite(LOW);
   pinMode(dataPin, INPUT);
-  digitalWrite(dataPin, HIGH);
+  dataWrite(HIGH);
 
   for (int i = 0; i < 8; i++)
   {
     temp <<= 1;  // MSB first on TM1650, so shift left
 
-    digitalWrite(clockPin, HIGH);
+    clockWrite(HIGH);
     bitDelay();		// NOTE: on TM1637 reading keys should be slower than 250Khz (see datasheet p3)
 
-    if (digitalRead(dataPin)) {
+    if (dataRead()) {
       temp |= 0x01;	 // MSB first on TM1650, so set lowest bit
     }
 
-    digitalWrite(clockPin, LOW);
+    clockWrite(LOW);
     bitDelay();
   }
 
 	// receive Ack
 	// TODO: currently the logical analyzer reports a NAK for the received value.
 	// I'd like to see an ACK instead as all data transfer seems okay.
-  digitalWrite(clockPin, LOW);
-  //digitalWrite(dataPin, HIGH);
+  clockWrite(LOW);
+  //dataWrite(HIGH);
   pinMode(dataPin, INPUT);
-  digitalWrite(dataPin, HIGH);
+  dataWrite(HIGH);
   bitDelay();
-  digitalWrite(clockPin, HIGH);
+  clockWrite(HIGH);
   bitDelay();
-  uint8_t ack = digitalRead(dataPin);
-  digitalWrite(clockPin, LOW);
+  uint8_t ack = dataRead();
+  clockWrite(LOW);
   if (ack == 0)
-	  digitalWrite(dataPin, LOW);
+	  dataWrite(LOW);
   pinMode(dataPin, OUTPUT);
 
   return temp;
 }
 
+byte TM1650::getKeyScanPeriod()
+{ // The datasheet specifies a key scan period of 7ms (the response time to a key press is up to 40ms)
+  return(7);
+}
+
 uint32_t TM1650::getButtons()
 {	// Keyscan data on the TM1650/TM1637 is one byte, with index of the button that is pressed.
 	// TM1650 supports 7x4 buttons (A-G via 2K resistors to DIG1-DIG4). 
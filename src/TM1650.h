@@ -35,7 +35,13 @@ class TM1650 : public TM16xx
     // TODO: remove deprecated parameters - how about displaymode that is needed by TM1650 and cannot be determined using numDigits?
     virtual void clearDisplay();
     virtual void setupDisplay(bool active, byte intensity);
+    virtual void setLevel(byte nLevel);
     virtual uint32_t getButtons();
+    virtual byte getKeyScanPeriod();
+    virtual bool service(byte nMaxBytes=TM16XX_SERVICE_BYTES, uint16_t uMaxMicros=0);
+#if(TM16XX_OPT_BACKGROUND)
+    virtual bool tick() { return(false); }   // background refresh is not supported, use service() instead
+#endif
 
   protected:
 #if defined(__AVR_ATtiny85__) ||  defined(__AVR_ATtiny13__) ||  defined(__AVR_ATtiny44__)
@@ -46,6 +52,10 @@ class TM1650 : public TM16xx
     virtual void start();
     virtual void stop();
     virtual void send(byte data);
+#if(TM16XX_OPT_SPI)
+    using TM16xx::setSPI;   // hardware SPI is only supported by 3-wire chips
+    virtual bool canUseSPI() { return(false); }
+#endif
     virtual void sendData(byte address, byte data);
     virtual byte receive();
 };
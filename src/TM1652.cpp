@@ -50,6 +50,22 @@ void TM1652::stop()
 { // For the TM1652, start and stop are sent using serial UART protocol so no separate start or stop
 }
 
+#if(TM1652_OPT_SERIAL)
+void TM1652::setSerial(HardwareSerial *pSerial)
+{ // Use the TX pin of a hardware UART to send data to the TM1652. The UART sends the bytes from its buffer in the
+  // background, so sending a command hardly delays the sketch. Note that the UART can't be used for anything else.
+  // The TM1652 expects 19200bps, 8 data bits, odd parity and one stop bit (the same bits send() produces).
+  // On ESP32 the TX pin is routed to the data pin specified in the constructor. On other MCUs connect DIN
+  // to the default TX pin of the UART and specify that pin as data pin in the constructor.
+  _pSerial=pSerial;
+#if defined(ARDUINO_ARCH_ESP32)
+  _pSerial->begin(19200, SERIAL_8O1, -1, dataPin);
+#else
+  _pSerial->begin(19200, SERIAL_8O1);
+#endif
+}
+#endif
+
 void TM1652::send(byte data)
 {	// Send a byte to the chip the way the TM1652 likes it (LSB-first, UART serial 8E1 - 8 bits, parity bit set to 0 when odd, one stop bit)
 	// Note: while segment data is LSB-first, address bits and SEG/GRID intensity bit are reversed
@@ -61,6 +77,15 @@ void TM1652::send(byte data)
   #define TM1652_BITDELAY 49     // NOTE: core 1.0.6 of LGT8F328@32MHz miscalculates delayMicroseconds() (should be 52us delay). For fix see https://github.com/dbuezas/lgt8fx/issues/18
   bool fParity=true;
 
+#if(TM1652_OPT_SERIAL)
+  if(_pSerial)
+  { // the UART sends the byte in the background
+    _pSerial->write(data);
+    _nCmdBytes++;
+    return;
+  }
+#endif
+
   // Note: To improve timing accuracy, sending data should not be interrupted. 
   // However, having interrupts may be required by timing functions such as delayMicroseconds (e.g. on RP2040)
   // Interrupts during data could be a bigger issue on slower processors.
@@ -90,15 +115,31 @@ void TM1652::send(byte data)
   delayMicroseconds(TM1652_BITDELAY);
 }
 
-void TM1652::waitCmd(void)
-{ // Wait for at least 3ms since previous call to ensure TM1652 treats next byte as new command
+bool TM1652::isReady()
+{ // Check if at least 3ms passed since the end of the previous command, so the TM1652 treats the next byte as new command
   // Datasheet: "Time: Data line high time (minimum time is 3ms)"
-  #define TM1652_WAITCMD 3000L
-  while(micros() < tLastCmd + TM1652_WAITCMD);    // NOTE: tLastCmd is 32-bit => wrap-around is about 4295 sec
+  // NOTE: the signed difference handles the wrap-around of micros() and an end time that is still in the future
+  return((int32_t)(micros()-tLastCmd) >= TM1652_WAITCMD);
+}
+
+void TM1652::waitCmd(void)
+{ // Wait until the next command can be sent
+  while(!isReady());
+#if(TM1652_OPT_SERIAL)
+  _tCmdStart=micros();
+  _nCmdBytes=0;
+#endif
 }
 
 void TM1652::endCmd(void)
 { // signal the end of a command, to remember the timing
+#if(TM1652_OPT_SERIAL)
+  if(_pSerial)
+  { // the UART is still sending, the command ends when all bytes are sent
+    tLastCmd=_tCmdStart+_nCmdBytes*TM1652_BYTETIME;
+    return;
+  }
+#endif
   tLastCmd=micros();
 }
 
@@ -106,12 +147,48 @@ void TM1652::sendData(byte address, byte data)
 {	// TM1652 uses different commands than other TM16XX chips
   //   byte positions[]={B00001000, B10001000, B01001000, B11001000, B00101000, B10101000};
   begin();    // begin() is implicitly called upon first sending of display data, but only executes once.
+  if(!shadowWrite(address, data))
+    return;   // data is unchanged or will be sent by flush()
   waitCmd();
   send(TM1652_CMD_ADDRESS | reverseByte(address&0x07));						// address command + address (reversed as documented)
   send(data);
   endCmd();
 }
 
+bool TM1652::service(byte nMaxBytes, uint16_t uMaxMicros)
+{ // Send the changed span of buffered display data in one command, using the auto-incremented address (like clearDisplay()).
+  // The span is cut short when the limits of this call are reached (see TM16xx::service()).
+  // When limits are set, service() doesn't wait for the gap between commands. It returns and tries again at the next call.
+  // Using the UART, a full update of the display is then queued without delay. The same applies to the fade.
+  if(!(nMaxBytes || uMaxMicros) || isReady())
+    fadeStep();
+#if(TM16XX_OPT_SHADOWRAM)
+  _uShadowDirty&=bit(_maxDisplays)-1;
+  if(!_uShadowDirty)
+    return(true);
+  if((nMaxBytes || uMaxMicros) && !isReady())
+    return(false);
+  uint32_t tStart=micros();
+  byte nFirst=0, nLast=_maxDisplays-1;
+  while(!(_uShadowDirty & bit(nFirst))) nFirst++;
+  while(!(_uShadowDirty & bit(nLast))) nLast--;
+  waitCmd();
+  send(TM1652_CMD_ADDRESS | reverseByte(nFirst));
+  for(byte nAddress=nFirst; nAddress<=nLast; nAddress++)
+  {
+    if(nAddress>nFirst && serviceSpent(nAddress-nFirst+1, nMaxBytes, tStart, uMaxMicros))
+      break;
+    send(_btShadowRam[nAddress]);
+    _uShadowDirty&=~bit(nAddress);
+    _dwWritesPerformed++;
+  }
+  endCmd();
+  return(_uShadowDirty==0);
+#else
+  return(true);
+#endif
+}
+
 void TM1652::sendCommand(byte cmd)
 { // send a display command
   waitCmd();
@@ -129,6 +206,13 @@ void TM1652::clearDisplay()
   	send(0);
   }
   endCmd();
+
+#if(TM16XX_OPT_SHADOWRAM)
+  // the display memory is now known to be empty
+  memset(_btShadowRam, 0, _maxDisplays);
+  _uShadowValid|=bit(_maxDisplays)-1;
+  _uShadowDirty=0;
+#endif
 }
 
 void TM1652::setupDisplay(bool active, byte intensity, byte driveCurrent)
@@ -142,6 +226,20 @@ void TM1652::setupDisplay(bool active, byte intensity, byte driveCurrent)
 	// sendCommand(0xEE);
   // sendCommand((active ? 0xF0 : 0) | reverseByte((intensity&0x07)<<4) | (_maxSegments==8? TM1652_DISPMODE_5x8 : TM1652_DISPMODE_6x7));
   sendCommand((active ? reverseByte(((intensity&0x07)<<1)|0x01) : 0) | (active ? (reverseByte((driveCurrent + 0x01)&0x07) >> 4) : 0) | (_maxSegments==8? 0 : 1));
+  _nDriveCurrent=driveCurrent;
+  levelSetup(active, intensity&0x07);
+}
+
+byte TM1652::getLevels()
+{ // The TM1652 has 16 levels of duty cycle
+  return(16);
+}
+
+void TM1652::setLevel(byte nLevel)
+{ // Set one of the 16 duty cycle levels, keeping the drive current as set by setupDisplay()
+  nLevel=min(nLevel, 16);
+  sendCommand((nLevel ? reverseByte(nLevel-1) | (reverseByte((_nDriveCurrent + 0x01)&0x07) >> 4) : 0) | (_maxSegments==8? 0 : 1));
+  _nLevel=nLevel;
 }
 
 byte TM1652::reverseByte(byte b)
@@ -23,6 +23,19 @@ Made by Maxint R&D. See https://github.com/maxint-rd
 #define TM1652_CMD_MODE  0x18
 #define TM1652_CMD_ADDRESS  0x08
 
+// Timing of the serial protocol: 19200bps, 11 bits per byte (start, 8 data, parity, stop)
+#define TM1652_WAITCMD 3000L        // minimal time between commands in us
+#define TM1652_BYTETIME 573L        // time to send one byte in us
+
+// Hardware UART support: the TX pin of a HardwareSerial port can drive DIN, instead of bit-banging.
+#ifndef TM1652_OPT_SERIAL
+  #if defined(__AVR_ATtiny85__) ||  defined(__AVR_ATtiny45__) ||  defined(__AVR_ATtiny13__) ||  defined(__AVR_ATtiny44__) ||  defined(__AVR_ATtiny84__)
+    #define TM1652_OPT_SERIAL 0      // these MCUs have no hardware UART
+  #else
+    #define TM1652_OPT_SERIAL 1
+  #endif
+#endif
+
 class TM1652 : public TM16xx
 {
   public:
@@ -37,11 +50,26 @@ class TM1652 : public TM16xx
        //       TM16xx method may be called instead of overloaded class method. To avoid this we explicitely 
        //       implementent a version setupDisplay() that uuses that default.
     virtual void begin(bool activateDisplay=true, byte intensity=7, byte driveCurrent = 6);
+    virtual byte getLevels();
+    virtual void setLevel(byte nLevel);   // 16 levels of duty cycle, using the drive current set by setupDisplay()
+    virtual bool service(byte nMaxBytes=TM16XX_SERVICE_BYTES, uint16_t uMaxMicros=0);
+    bool isReady();   // true when the next command can be sent without waiting
+#if(TM1652_OPT_SERIAL)
+    /** Use a hardware UART to send the data. Connect its TX pin to DIN. Call in setup() before begin() */
+    void setSerial(HardwareSerial *pSerial);
+#endif
+#if(TM16XX_OPT_BACKGROUND)
+    virtual bool tick() { return(false); }   // background refresh is not supported, use service() instead
+#endif
 
   protected:
     virtual void start();
     virtual void stop();
     virtual void send(byte data);
+#if(TM16XX_OPT_SPI)
+    using TM16xx::setSPI;   // hardware SPI is only supported by 3-wire chips
+    virtual bool canUseSPI() { return(false); }
+#endif
     virtual void sendData(byte address, byte data);
     virtual void sendCommand(byte cmd);
 
@@ -49,7 +77,13 @@ class TM1652 : public TM16xx
     byte reverseByte(byte b);
     void waitCmd(void);
     void endCmd(void);
-    uint32_t tLastCmd;
+    uint32_t tLastCmd=0;       // time the last command ended (may be in the future when using the UART)
+    byte _nDriveCurrent=6;     // drive current as set by setupDisplay(), used by setLevel()
+#if(TM1652_OPT_SERIAL)
+    HardwareSerial *_pSerial=NULL;
+    uint32_t _tCmdStart;
+    byte _nCmdBytes;
+#endif
 };
 
 #endif
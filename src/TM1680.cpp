@@ -66,6 +66,15 @@ Made by Maxint R&D. See https://github.com/maxint-rd
   #include <Wire.h>       // needed for I2C
 #endif
 
+// Maximum number of data bytes in one transaction, the Wire buffer also holds the address byte
+#if defined(BUFFER_LENGTH)
+  #define TM1680_I2C_CHUNK (BUFFER_LENGTH-1)
+#elif defined(I2C_BUFFER_LENGTH)
+  #define TM1680_I2C_CHUNK (I2C_BUFFER_LENGTH-1)
+#else
+  #define TM1680_I2C_CHUNK 16
+#endif
+
 TM1680::TM1680(byte i2cAddress, byte sdaPin, byte sclPin, byte numDigits)
 	: TM16xx(sdaPin, sclPin, sdaPin, TM1680_MAX_POS, numDigits)
 { // The TM1680 has I2C using SDA and SCL on default address [TODO 0x??]. In the parent-constructor DIN, CLK and STB are initialized, but not used.
@@ -133,7 +142,7 @@ void TM1680::begin(bool activateDisplay, byte intensity)
   #else
     Wire.begin();
   #endif
-  Wire.setClock(100000L);     // NOTE: when setting a speed that's not supported 400k is used on ESP/LGT. Only 100k and 400k seem to be supported on LGT8F328P
+  Wire.setClock(_uI2cClock);     // NOTE: when setting a speed that's not supported 400k is used on ESP/LGT. Only 100k and 400k seem to be supported on LGT8F328P
 #endif
 
 /*
@@ -166,6 +175,16 @@ void TM1680::begin(bool activateDisplay, byte intensity)
   setupDisplay(activateDisplay, intensity);
 } 
   
+void TM1680::setI2CClock(uint32_t uClock)
+{ // Set the I2C clock speed. Default is 100kHz. The TM1680 supports up to 400kHz.
+  // Faster speeds reduce the time needed to refresh large displays. Can be called before or after begin().
+  _uI2cClock=uClock;
+#if !defined(CH32X033F8P)
+  if(this->fBeginDone)
+    Wire.setClock(_uI2cClock);
+#endif
+}
+
 void TM1680::start()
 { // For the TM1680, start and stop are sent using I2C protocol so no separate start or stop
 }
@@ -182,23 +201,93 @@ void TM1680::send(byte data)
   Wire.endTransmission();
 }
 
+void TM1680::frameWrite(byte nIndex, byte data)
+{ // Update a byte in the framebuffer and extend the changed range. Unchanged data is skipped.
+  if(nIndex>=TM1680_RAM_SIZE)
+    return;
+  if(_btFrame[nIndex]==data)
+  {
+#if(TM16XX_OPT_SHADOWRAM)
+    _dwWritesSuppressed++;
+#endif
+    return;
+  }
+  _btFrame[nIndex]=data;
+  _nFrameDirtyFirst=__min(_nFrameDirtyFirst, nIndex);
+  _nFrameDirtyLast=__max(_nFrameDirtyLast, nIndex);
+}
+
 void TM1680::sendData(byte address, byte data)
 {	// Note: TM1680 uses different commands than other TM16xx chips
+  // The data is written to the framebuffer. Each byte holds two 4-bit addresses of the display memory.
   begin();    // begin() is implicitly called upon first sending of display data, but only executed once.
-  Wire.beginTransmission(_i2cAddress);
-  Wire.write(TM1680_CMD_ADDRESS | ((address&0x07)<<1));
-  Wire.write(data);
-  Wire.endTransmission();
+  frameWrite(address&0x1F, data);
+#if(TM16XX_OPT_SHADOWRAM)
+  if(_fBuffered)
+    return;   // will be sent by flush()
+#endif
+  flush();
 }
 
 void TM1680::sendData16(byte address, uint16_t data)
 {	// Note: TM1680 uses different commands than other TM16xx chips
   begin();    // begin() is implicitly called upon first sending of display data, but only executed once.
-  Wire.beginTransmission(_i2cAddress);
-  Wire.write(TM1680_CMD_ADDRESS | ((address&0x1F)<<2));
-  Wire.write(data&0x00FF);    // data address increments automaticaly, first write segments 0-7
-  Wire.write(data>>8);        // then write segments 8-15
-  Wire.endTransmission();
+  frameWrite((address&0x1F)<<1, data&0x00FF);    // data address increments automaticaly, first write segments 0-7
+  frameWrite(((address&0x1F)<<1)+1, data>>8);   // then write segments 8-15
+#if(TM16XX_OPT_SHADOWRAM)
+  if(_fBuffered)
+    return;   // will be sent by flush()
+#endif
+  flush();
+}
+
+void TM1680::flush()
+{ // Send all changed data of the framebuffer
+  service(0, 0);
+}
+
+bool TM1680::service(byte nMaxBytes, uint16_t uMaxMicros)
+{ // Send the changed range of the framebuffer using the auto-incremented address of the TM1680.
+  // The range is sent in as few transactions as the Wire buffer allows. Like TM16xx::service() the amount of data
+  // per call can be limited, in which case sending continues at the next call. A 16-COM digit is never split.
+  fadeStep();
+  if(_nFrameDirtyFirst>_nFrameDirtyLast)
+    return(true);
+  uint32_t tStart=micros();
+  byte nGridBytes=(_maxSegments>8 ? 2 : 1);
+  byte nSent=0;
+  while(_nFrameDirtyFirst<=_nFrameDirtyLast)
+  {
+    if(nSent && serviceSpent(nSent+nGridBytes, nMaxBytes, tStart, uMaxMicros))
+      break;
+    byte nLength=__min(_nFrameDirtyLast-_nFrameDirtyFirst+1, TM1680_I2C_CHUNK);
+    if(nMaxBytes && nLength>nMaxBytes-nSent)
+      nLength=__max(nMaxBytes-nSent, nGridBytes);
+    if(nLength<_nFrameDirtyLast-_nFrameDirtyFirst+1 && nLength>nGridBytes)
+      nLength-=(_nFrameDirtyFirst+nLength)%nGridBytes;   // end at a digit boundary
+    Wire.beginTransmission(_i2cAddress);
+    Wire.write(TM1680_CMD_ADDRESS | (_nFrameDirtyFirst<<1));    // address of 4-bit RAM
+    for(byte n=0; n<nLength; n++)
+      Wire.write(_btFrame[_nFrameDirtyFirst+n]);
+    Wire.endTransmission();
+    _nFrameDirtyFirst+=nLength;
+    nSent+=nLength;
+#if(TM16XX_OPT_SHADOWRAM)
+    _dwWritesPerformed+=nLength;
+#endif
+  }
+  if(_nFrameDirtyFirst>_nFrameDirtyLast)
+  { // all sent
+    _nFrameDirtyFirst=0xFF;
+    _nFrameDirtyLast=0;
+    return(true);
+  }
+  return(false);
+}
+
+bool TM1680::hasPendingData()
+{
+  return(_nFrameDirtyFirst<=_nFrameDirtyLast);
 }
 
 void TM1680::sendCommand(byte cmd)
@@ -211,12 +300,12 @@ void TM1680::sendCommand(byte cmd)
 void TM1680::clearDisplay()
 {	// Clear all data registers. The address of the 4-bit registers is 0x00 to 0x5F on TM1680 depending the display mode.
   // This becomes either 24 16-bit addresses or 32 8-bit addresses.
-	for (int i = 0; i < _maxDisplays; i++) {
-    if(_maxDisplays>24)
-      sendData(i, 0);    // clear 32 x 8-COM (64x4-bit)
-    else
-      sendData16(i, 0);  // clear 24 x 16-COM (94x4-bit)
-  }
+  // The whole memory is sent at once using the auto-incremented address: 32 x 8-COM (64x4-bit) or 24 x 16-COM (96x4-bit)
+  begin();    // begin() is implicitly called upon first sending of display data, but only executed once.
+  memset(_btFrame, 0, TM1680_RAM_SIZE);
+  _nFrameDirtyFirst=0;
+  _nFrameDirtyLast=(_maxDisplays>24 ? 32 : TM1680_RAM_SIZE)-1;
+  flush();
 }
 
 void TM1680::setupDisplay(bool active, byte intensity)    // intensity=7
@@ -224,6 +313,26 @@ void TM1680::setupDisplay(bool active, byte intensity)    // intensity=7
   // Note that the distribution of these  8 levels is sligthly different from the uneven distribution of many TM16xx chips.
   sendCommand(active ? TM1680_LED_ON : TM1680_LED_OFF);
   sendCommand(TM1680_PWM_DUTY_0 | (((intensity&0x07)<<1)|0x01));
+  levelSetup(active, intensity&0x07);
+}
+
+byte TM1680::getLevels()
+{ // The TM1680 has 16 levels of PWM duty
+  return(16);
+}
+
+void TM1680::setLevel(byte nLevel)
+{ // Set one of the 16 PWM duty levels. The LEDs are switched on or off only when needed.
+  nLevel=min(nLevel, 16);
+  if(!nLevel)
+    sendCommand(TM1680_LED_OFF);
+  else
+  {
+    if(!_nLevel)
+      sendCommand(TM1680_LED_ON);
+    sendCommand(TM1680_PWM_DUTY_0 | (nLevel-1));
+  }
+  _nLevel=nLevel;
 }
 
 
@@ -45,6 +45,7 @@ Made by Maxint R&D. See https://github.com/maxint-rd
 // addresses 0x00 - 0x5F = 0-95 in 24x16 mode, 0x00 - 0x3F = 0-63 in 32x8 mode
 // Two bytes per 16 com-digit: First digit: seg0-7: 0x00, seg 8-15: 0x01
 #define TM1680_CMD_ADDRESS           0x00
+#define TM1680_RAM_SIZE 48     // 96 4-bit addresses, 2 per byte
 
 // modes for setting interrupt pin and reading buttons are not supported (yet)
 
@@ -59,7 +60,15 @@ class TM1680 : public TM16xx
     // TODO: remove deprecated parameters - TM1680(byte i2cAddress, byte sdaPin, byte sclPin, byte numDigits=4);
     virtual void clearDisplay();
     virtual void setupDisplay(bool active, byte intensity=7);
+    virtual byte getLevels();
+    virtual void setLevel(byte nLevel);   // 16 levels of PWM duty
     virtual void begin(bool activateDisplay=true, byte intensity=7);
+    void setI2CClock(uint32_t uClock=TM16XX_I2C_CLOCK);   // set I2C speed, e.g. 400000L. Can be called before begin()
+
+    // The display memory is kept in a framebuffer. Changed data is sent using auto-increment addressing.
+    virtual void flush();
+    virtual bool service(byte nMaxBytes=TM16XX_SERVICE_BYTES, uint16_t uMaxMicros=0);
+    virtual bool hasPendingData();
 
 	  virtual void setSegments(byte segments, byte position);   // will duplicate G to G1/G2 in 15-segment
 	  virtual void setSegments16(uint16_t segments, byte position);   // some modules support more than 8 segments
@@ -79,6 +88,10 @@ class TM1680 : public TM16xx
     virtual void start();
     virtual void stop();
     virtual void send(byte data);
+#if(TM16XX_OPT_SPI)
+    using TM16xx::setSPI;   // hardware SPI is only supported by 3-wire chips
+    virtual bool canUseSPI() { return(false); }
+#endif
     virtual void sendData(byte address, byte data);
     virtual void sendData16(byte address, uint16_t data);
     virtual void sendCommand(byte cmd);
@@ -88,6 +101,11 @@ class TM1680 : public TM16xx
 		uint16_t mapSegments16(uint16_t segments);
     bool fAlphaNumeric=true;     // If true use 14-segment alphanumeric  display when having at least 13 SEG (15-seg: 14-segments plus dot)
     uint8_t _i2cAddress;
+    uint32_t _uI2cClock=TM16XX_I2C_CLOCK;
+    byte _btFrame[TM1680_RAM_SIZE]={0};   // copy of the display memory
+    byte _nFrameDirtyFirst=0xFF;          // changed range in the framebuffer, empty when first>last
+    byte _nFrameDirtyLast=0;
+    void frameWrite(byte nIndex, byte data);
 		//const PROGMEM byte *_pSegmentMap=NULL;               // pointer to segment map set using setSegmentMap()
 		//PGM_P _pSegmentMap=NULL;               // pointer to segment map set using setSegmentMap() - PGM_P needed in ESP8266 core 3.0.2
     const byte *_pSegmentMap=NULL;               // pointer to segment map set using setSegmentMap() - PGM_P needed in ESP8266 core 3.0.2
@@ -18,6 +18,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "TM16xx.h"
+#if(TM16XX_OPT_BACKGROUND) && defined(ARDUINO_ARCH_RP2040)
+  #include "hardware/sync.h"    // save_and_disable_interrupts() used by tickHold()
+#endif
 
 TM16xx::TM16xx(byte dataPin, byte clockPin, byte strobePin, byte maxDisplays, byte nDigitsUsed, bool activateDisplay,	byte intensity)
 {
@@ -34,6 +37,11 @@ TM16xx::TM16xx(byte dataPin, byte clockPin, byte strobePin, byte maxDisplays, by
 
   digitalWrite(strobePin, HIGH);
   digitalWrite(clockPin, HIGH);
+#if(TM16XX_OPT_FASTGPIO)
+  _fpData.begin(dataPin);
+  _fpClock.begin(clockPin);
+  _fpStrobe.begin(strobePin);
+#endif
 
   // NOTE: CONSTRUCTORS SHOULD NOT CALL DELAY() <= gives hanging on certain ESP8266/ESP32 cores as well as on LGT8F328P 
   // Using micros() or millis() in constructor also gave issues on LST8F328P and CH32V003.
@@ -47,7 +55,101 @@ void TM16xx::setupDisplay(bool active, byte intensity)
 { // Set the display intensity and switch it on/off
   // Some TM16xx classes (e.g. TM1650) use _maxSegments in setupDisplay() to also set the display mode.
   sendCommand(TM16XX_CMD_DISPLAY | (active ? 8 : 0) | min(7, intensity));
+  levelSetup(active, intensity);
+}
+
+void TM16xx::setupDisplays(TM16xx *aModules[], byte nModules, bool active, byte intensity)
+{ // Set the intensity and switch multiple modules on/off. A group of modules on a shared bus gets the display control
+  // command all at once (this sets all modules of that group, also those not in aModules). Other modules are set one
+  // after the other, using the setupDisplay() method of their chip.
+  // NOTE: I2C chips (TM1680, HT16K33) don't support the I2C general call, so they still need a transaction each.
+  for(byte n=0; n<nModules; n++)
+  {
+    TM16xxGroup *pGroup=aModules[n]->_pGroup;
+    if(!pGroup)
+    {
+      aModules[n]->setupDisplay(active, intensity);
+      continue;
+    }
+    bool fDone=false;
+    for(byte nPrev=0; nPrev<n; nPrev++)
+      fDone|=(aModules[nPrev]->_pGroup==pGroup);
+    if(!fDone)
+      pGroup->setupDisplay(active, intensity);   // the group was not set yet
+  }
+}
+
+byte TM16xx::getLevels()
+{ // Most TM16xx chips have 8 intensity levels (the pulse width of the display control command)
+  return(8);
+}
+
+void TM16xx::setLevel(byte nLevel)
+{ // Set the intensity using the display control command only (also when setupDisplay() of the chip sends more commands)
+  nLevel=min(nLevel, 8);
+  sendCommand(TM16XX_CMD_DISPLAY | (nLevel ? 8|(nLevel-1) : 0));
+  _nLevel=nLevel;
+}
+
+byte TM16xx::getLevel()
+{
+  return(_nLevel);
+}
+
+void TM16xx::levelSetup(bool active, byte intensity)
+{ // Translate the intensity (0-7) of setupDisplay() to the level of the chip. Setting the display stops a running fade.
+  // Chips with 16 levels use the odd duty cycles, i.e. intensity 0 is level 2 and intensity 7 is level 16.
+  _nLevel=active ? __max(1, (__min(7, intensity)+1)*getLevels()/8) : 0;
+#if(TM16XX_OPT_FADE)
+  _fFading=false;
+#endif
+}
+
+#if(TM16XX_OPT_FADE)
+void TM16xx::fadeTo(byte nLevel, uint16_t uDuration, byte nEasing)
+{ // Start fading from the current level to the specified level. Each call of service() sets the level for the time
+  // passed. A fade of 0 ms sets the level right away.
+  _nFadeFrom=_nLevel;
+  _nFadeTo=__min(nLevel, getLevels());
+  _nFadeEasing=nEasing;
+  _uFadeDuration=uDuration;
+  _tFadeStart=millis();
+  _fFading=true;
+  fadeStep();
+}
+
+bool TM16xx::isFading()
+{
+  return(_fFading);
+}
+
+void TM16xx::fadeStep()
+{ // Determine the level of a running fade and send it when it differs from the current level.
+  // The position within the fade is calculated in 1/256 steps and then eased using integer math.
+  if(!_fFading)
+    return;
+  uint32_t tPassed=millis()-_tFadeStart;
+  bool fDone=(tPassed>=_uFadeDuration);
+  uint32_t uPos=fDone ? 256 : (tPassed*256)/_uFadeDuration;
+  switch(_nFadeEasing)
+  {
+  case TM16XX_EASE_IN:
+    uPos=(uPos*uPos)>>8;
+    break;
+  case TM16XX_EASE_OUT:
+    uPos=256-(((256-uPos)*(256-uPos))>>8);
+    break;
+  case TM16XX_EASE_INOUT:
+    uPos=(uPos*uPos*(768-2*uPos))>>16;     // smoothstep: 3x^2-2x^3
+    break;
+  }
+  int16_t nDiff=(int16_t)_nFadeTo-_nFadeFrom;
+  byte nLevel=_nFadeFrom+(nDiff*(int16_t)uPos+(nDiff<0 ? -128 : 128))/256;   // rounded to the nearest level
+  if(nLevel!=_nLevel)
+    setLevel(nLevel);
+  _fFading=!fDone;
 }
+#endif
 
 void TM16xx::clearDisplay()
 {	// Clear all data registers. The number of registers depends on the chip.
@@ -67,6 +169,18 @@ void TM16xx::clearDisplay()
   }
 	stop();
 
+  shadowCleared();
+}
+
+void TM16xx::shadowCleared()
+{ // Called after clearing the display memory: the cleared part is now known to be empty, so there is nothing left to flush
+#if(TM16XX_OPT_SHADOWRAM)
+  byte nBytes=__min(TM16XX_SHADOWRAM_SIZE, _maxDisplays * (_maxSegments>8 ? 2 : 1));
+  uint16_t uCleared=(nBytes>=16) ? 0xFFFF : (uint16_t)(bit(nBytes)-1);
+  memset(_btShadowRam, 0, nBytes);
+  _uShadowValid|=uCleared;
+  _uShadowDirty&=~uCleared;
+#endif
 }
 
 void TM16xx::begin(bool activateDisplay, byte intensity)
@@ -80,6 +194,290 @@ void TM16xx::begin(bool activateDisplay, byte intensity)
   clearDisplay();
   setupDisplay(activateDisplay, intensity);
 } 
+
+void TM16xx::setBuffered(bool fBuffered)
+{ // Set buffered mode. In buffered mode sendData() only updates the shadow RAM. Call flush() to update the display.
+  // This allows sending all changes of a complete screen update in a single auto-increment transaction.
+  // Leaving buffered mode will send all pending data.
+#if(TM16XX_OPT_SHADOWRAM)
+  if(!fBuffered)
+    flush();
+  _fBuffered=fBuffered;
+#endif
+}
+
+bool TM16xx::isBuffered()
+{
+#if(TM16XX_OPT_SHADOWRAM)
+  return(_fBuffered);
+#else
+  return(false);
+#endif
+}
+
+void TM16xx::flush()
+{ // Send all changed data of the shadow RAM.
+  service(0, 0);
+}
+
+bool TM16xx::service(byte nMaxBytes, uint16_t uMaxMicros)
+{ // Send the changed runs of the shadow RAM using auto-increment addressing (similar to clearDisplay()).
+  // Compared to sending each byte using fixed addressing, this saves the data command, the address and a start/stop per byte.
+  // Separate runs of changed bytes are sent after a single data command. A single unchanged byte in between is resent
+  // as that is cheaper than starting a new run. Chips with their own protocol override this method.
+  // In buffered mode, calling service() from loop() sends at most nMaxBytes bytes or runs for about uMaxMicros microseconds
+  // per call (0=no limit). Sending continues at the next call. The limit is only checked between grids, so a grid that
+  // uses two bytes (e.g. TM1638) is always updated at once. At least one grid is sent per call.
+  // Returns true when all changed data was sent.
+  fadeStep();
+#if(TM16XX_OPT_SHADOWRAM)
+  if(!_uShadowDirty)
+    return(true);   // nothing to send
+  uint32_t tStart=micros();
+  sendCommand(TM16XX_CMD_DATA_AUTO);		// set auto increment addressing mode
+  sendRuns(0, nMaxBytes, tStart, uMaxMicros);
+  return(_uShadowDirty==0);
+#else
+  return(true);
+#endif
+}
+
+byte TM16xx::sendRuns(byte nSent, byte nMaxBytes, uint32_t tStart, uint16_t uMaxMicros)
+{ // Send the changed runs of the shadow RAM, assuming the auto increment data command was sent already.
+  // nSent is the number of bytes sent so far in this call of service(). Returns the new total.
+#if(TM16XX_OPT_SHADOWRAM)
+  byte nGridBytes=(_maxSegments>8 ? 2 : 1);   // same assumption as clearDisplay()
+  byte nAddress=0;
+  while(_uShadowDirty)
+  {
+    while(!(_uShadowDirty & bit(nAddress)))
+      nAddress++;
+    if(nSent && serviceSpent(nSent+nGridBytes, nMaxBytes, tStart, uMaxMicros))
+      break;
+    byte nLast=nAddress;
+    while(nLast+1<TM16XX_SHADOWRAM_SIZE)
+    {
+      if(_uShadowDirty & bit(nLast+1))
+        nLast++;
+      else if(nLast+2<TM16XX_SHADOWRAM_SIZE && (_uShadowDirty & bit(nLast+2)) && (_uShadowValid & bit(nLast+1)))
+        nLast+=2;
+      else
+        break;
+    }
+    start();
+    send(TM16XX_CMD_ADDRESS | nAddress);
+    for(; nAddress<=nLast; nAddress++)
+    {
+      if(nSent && (nAddress%nGridBytes)==0 && serviceSpent(nSent+nGridBytes, nMaxBytes, tStart, uMaxMicros))
+        break;    // continue with this grid at the next call
+      send(_btShadowRam[nAddress]);
+      _uShadowDirty&=~bit(nAddress);
+      _dwWritesPerformed++;
+      nSent++;
+    }
+    stop();
+    if(nAddress<=nLast)
+      break;
+  }
+#endif
+  return(nSent);
+}
+
+bool TM16xx::serviceSpent(byte nBytes, byte nMaxBytes, uint32_t tStart, uint16_t uMaxMicros)
+{ // Used by service() to check if sending nBytes in total would exceed the limits set for this call
+  return((nMaxBytes && nBytes>nMaxBytes) || (uMaxMicros && (micros()-tStart)>=uMaxMicros));
+}
+
+bool TM16xx::hasPendingData()
+{ // Returns true when buffered data is not sent yet
+#if(TM16XX_OPT_SHADOWRAM)
+  return(_uShadowDirty!=0);
+#else
+  return(false);
+#endif
+}
+
+#if(TM16XX_OPT_BACKGROUND)
+bool TM16xx::tick()
+{ // Background refresh state machine. Each call sends one byte of the changed display data, so it can be called from
+  // a timer interrupt without causing much delay. A run of changed bytes is sent using auto-increment addressing:
+  // first the data command, then the address and then one byte per call until the end of the run.
+  // Like in service() the runs are separated by at least two unchanged bytes.
+  // A run may take multiple calls, during which the strobe stays low. When the sketch starts a transaction of its own
+  // (e.g. to read the buttons), tickHold() ends the current run and tick() waits until the transaction is done.
+  // Returns true while there is data left to be sent.
+  if(_fTickHold)
+    return(true);   // the sketch is using the bus
+  _fInTick=true;
+  switch(_nTickState)
+  {
+  case TM16XX_TICK_IDLE:
+    if(_uShadowDirty)
+    {
+      _nTickAddress=0;
+      while(!(_uShadowDirty & bit(_nTickAddress)))
+        _nTickAddress++;
+      sendCommand(TM16XX_CMD_DATA_AUTO);		// set auto increment addressing mode
+      _nTickState=TM16XX_TICK_ADDRESS;
+    }
+    break;
+  case TM16XX_TICK_ADDRESS:
+    start();
+    send(TM16XX_CMD_ADDRESS | _nTickAddress);
+    _nTickState=TM16XX_TICK_DATA;
+    break;
+  case TM16XX_TICK_DATA:
+    _uShadowDirty&=~bit(_nTickAddress);   // data changed by the sketch after this will be sent again
+    send(_btShadowRam[_nTickAddress]);
+    _dwWritesPerformed++;
+    _nTickAddress++;
+    if(_nTickAddress>=TM16XX_SHADOWRAM_SIZE || !((_uShadowDirty & bit(_nTickAddress)) ||
+      ((_uShadowDirty & bit(_nTickAddress+1)) && (_uShadowValid & bit(_nTickAddress)))))
+    { // end of the run (like service() a single unchanged byte is resent, rather than starting a new run)
+      stop();
+      _nTickState=TM16XX_TICK_IDLE;
+    }
+    break;
+  }
+  _fInTick=false;
+  return(_nTickState!=TM16XX_TICK_IDLE || _uShadowDirty);
+}
+
+void TM16xx::tickHold()
+{ // Called by start() when the sketch starts a transaction. When tick() was halfway a run, that run is ended first.
+  // The remaining bytes are still marked as changed and will be sent later.
+  // Interrupts (or on ESP32 the task scheduler) are disabled, so tick() can't run in between.
+  // The previous interrupt state is restored afterwards, as the sketch may call this with interrupts disabled.
+  if(_fInTick)
+    return;
+#if defined(ARDUINO_ARCH_ESP32)
+  vTaskSuspendAll();
+#elif defined(__AVR__)
+  uint8_t oldSREG = SREG;
+  cli();
+#elif defined(ARDUINO_ARCH_ESP8266)
+  uint32_t uSavedPS = xt_rsil(15);
+#elif defined(ARDUINO_ARCH_RP2040)
+  uint32_t uSavedIRQ = save_and_disable_interrupts();
+#else
+  noInterrupts();   // other cores have no portable way to save the interrupt state
+#endif
+  _fTickHold=true;
+  tickEndRun();
+  for(TM16xx *pModule=_pBusNext; pModule && pModule!=this; pModule=pModule->_pBusNext)
+  { // modules on a shared bus (see TM16xxSharedBus) wait as well
+    pModule->_fTickHold=true;
+    pModule->tickEndRun();
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  xTaskResumeAll();
+#elif defined(__AVR__)
+  SREG = oldSREG;
+#elif defined(ARDUINO_ARCH_ESP8266)
+  xt_wsr_ps(uSavedPS);
+#elif defined(ARDUINO_ARCH_RP2040)
+  restore_interrupts(uSavedIRQ);
+#else
+  interrupts();
+#endif
+}
+
+void TM16xx::tickEndRun()
+{ // End the run that tick() was sending
+  if(_nTickState!=TM16XX_TICK_IDLE)
+  {
+    _fInTick=true;
+    if(_nTickState==TM16XX_TICK_DATA)
+      stop();
+    _nTickState=TM16XX_TICK_IDLE;
+    _fInTick=false;
+  }
+}
+
+void TM16xx::tickRelease()
+{ // Called by stop() at the end of a transaction of the sketch
+  if(_fInTick)
+    return;
+  _fTickHold=false;
+  for(TM16xx *pModule=_pBusNext; pModule && pModule!=this; pModule=pModule->_pBusNext)
+    pModule->_fTickHold=false;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+void TM16xx::tickTask(void *pvModule)
+{ // FreeRTOS task for background refresh. Sends a few bytes each millisecond.
+  TM16xx *pModule=(TM16xx *)pvModule;
+  for(;;)
+  {
+    for(byte n=0; n<pModule->_nTickBytes && pModule->tick(); n++);
+    vTaskDelay(1);
+  }
+}
+
+bool TM16xx::startBackgroundTask(byte nBytesPerTick, uint32_t uStackSize)
+{ // Start a task for background refresh. The task has a higher priority than the calling task (loop()) and runs on
+  // the same core. This way the task and the sketch can't use the bus at the same time.
+  if(_hTickTask)
+    return(true);
+  setBuffered(true);
+  _nTickBytes=nBytesPerTick;
+  return(xTaskCreatePinnedToCore(tickTask, "TM16xx", uStackSize, this, uxTaskPriorityGet(NULL)+1, &_hTickTask, xPortGetCoreID())==pdPASS);
+}
+
+void TM16xx::stopBackgroundTask()
+{ // Stop the background task. Data that was not sent yet can be sent using flush().
+  if(!_hTickTask)
+    return;
+  vTaskDelete(_hTickTask);
+  _hTickTask=NULL;
+  tickHold();     // end a run that is halfway
+  tickRelease();
+}
+#endif
+#endif // #if(TM16XX_OPT_BACKGROUND)
+
+#if(TM16XX_OPT_SPI)
+bool TM16xx::setSPI(SPIClass *pSPI, uint32_t uClock)
+{ // Use hardware SPI (mode 3, LSB first) instead of bit-banging. Only for 3-wire chips, as they use a separate strobe line.
+  // Connect SCK to CLK, MOSI to DIO and any pin to STB. Specify MOSI, SCK and STB as data, clock and strobe pins in
+  // the constructor of the chip class. To read buttons also connect MISO directly to DIO and put a resistor (e.g. 1K)
+  // between MOSI and DIO. While reading, 0xFF is sent so the chip can pull DIO low. On chips with separate data
+  // output (e.g. TM1629 DOUT) connect MISO to that pin instead. Most TM16xx chips support clock speeds up to 1MHz.
+  if(!canUseSPI())
+    pSPI=NULL;    // 2-wire chips keep bit-banging
+  _pSPI=pSPI;
+  _uSpiClock=uClock;
+  if(_pSPI)
+    _pSPI->begin();
+  return(_pSPI!=NULL);
+}
+#endif
+
+uint32_t TM16xx::getWritesPerformed()
+{ // return the number of display data bytes sent since the last reset of the counters
+#if(TM16XX_OPT_SHADOWRAM)
+  return(_dwWritesPerformed);
+#else
+  return(0);
+#endif
+}
+
+uint32_t TM16xx::getWritesSuppressed()
+{ // return the number of display data writes that were skipped because the data was unchanged
+#if(TM16XX_OPT_SHADOWRAM)
+  return(_dwWritesSuppressed);
+#else
+  return(0);
+#endif
+}
+
+void TM16xx::resetWriteCounters()
+{
+#if(TM16XX_OPT_SHADOWRAM)
+  _dwWritesPerformed=0;
+  _dwWritesSuppressed=0;
+#endif
+}
   
 
 void TM16xx::setSegments(byte segments, byte position)
@@ -211,6 +609,11 @@ uint32_t TM16xx::getButtons()
 	return(0);
 }
 
+byte TM16xx::getKeyScanPeriod()
+{ // Chips that specify the duration of their key scan override this. Reading more often gives the same key data.
+  return(0);
+}
+
 
 //
 //  Protected methods
@@ -227,7 +630,17 @@ void TM16xx::bitDelay()
   // An ESP32 running without delay at 240MHz gave a CLK of  ~0.3us (~ 1.6MHz)
   // An ESP8266 running without delay at 160MHz gave a CLK of  ~0.9us (~ 470kHz)
   // An ESP8266 running without delay  at 80MHz gave a CLK of  ~1.8us (~ 240kHz)
-	#if F_CPU>100000000
+  // When using fast GPIO (TM16XX_OPT_FASTGPIO) pins are toggled much faster, so semi-fast MCUs also need the delay.
+#if(TM16XX_OPT_SPI)
+  // When using hardware SPI the delay is only called between bytes. The datasheets specify a Twait of minimal 1us,
+  // which also applies between the read command and the first received byte.
+  if(_pSPI)
+  {
+    delayMicroseconds(1);
+    return;
+  }
+#endif
+	#if F_CPU>100000000 || (TM16XX_OPT_FASTGPIO && F_CPU>40000000)
 	//#if F_CPU>40000000    // semi-fast processeors like CH32V003 @48Mhz may also need some delay
   	delayMicroseconds(1);
   #endif
@@ -235,27 +648,45 @@ void TM16xx::bitDelay()
 
 void TM16xx::start()
 {	// if needed derived classes can use different patterns to start a command (eg. for TM1637)
-  digitalWrite(strobePin, LOW);
+  tickHold();
+#if(TM16XX_OPT_SPI)
+  if(_pSPI)
+    _pSPI->beginTransaction(SPISettings(_uSpiClock, LSBFIRST, SPI_MODE3));   // clock idles high, data is read on rising edge
+#endif
+  strobeWrite(LOW);
   bitDelay();
 }
 
 void TM16xx::stop()
 {	// if needed derived classes can use different patterns to stop a command (eg. for TM1637)
-  digitalWrite(strobePin, HIGH);
+  strobeWrite(HIGH);
   bitDelay();
+#if(TM16XX_OPT_SPI)
+  if(_pSPI)
+    _pSPI->endTransaction();
+#endif
+  tickRelease();
 }
 
 void TM16xx::send(byte data)
 {
 	// MMOLE 180203: shiftout does something, but is not okay (tested on TM1668)
 	//shiftOut(dataPin, clockPin, LSBFIRST, data);
+#if(TM16XX_OPT_SPI)
+  if(_pSPI)
+  {
+    _pSPI->transfer(data);
+    bitDelay();		// Twait between bytes
+    return;
+  }
+#endif
   for (int i = 0; i < 8; i++) {
-    digitalWrite(clockPin, LOW);
+    clockWrite(LOW);
     bitDelay();
-    digitalWrite(dataPin, data & 1 ? HIGH : LOW);
+    dataWrite(data & 1 ? HIGH : LOW);
     bitDelay();
     data >>= 1;
-    digitalWrite(clockPin, HIGH);
+    clockWrite(HIGH);
     bitDelay();
   }
   bitDelay();		// NOTE: TM1638 specifies a Twait between bytes of minimal 1us.
@@ -271,6 +702,8 @@ void TM16xx::sendCommand(byte cmd)
 void TM16xx::sendData(byte address, byte data)
 {
   begin();    // begin() is implicitly called upon first sending of display data, but executes only once.
+  if(!shadowWrite(address, data))
+    return;   // data is unchanged or will be sent by flush()
   sendCommand(TM16XX_CMD_DATA_FIXED);							// use fixed addressing for data
 	start();
   send(TM16XX_CMD_ADDRESS | address);						// address command + address
@@ -278,35 +711,65 @@ void TM16xx::sendData(byte address, byte data)
   stop();
 }
 
+bool TM16xx::shadowWrite(byte address, byte data)
+{ // Update the shadow RAM. Returns true when the data should be sent to the display right away.
+  // Data that the display already shows (or will show after flush()) is not sent again.
+  // Chips that override sendData() can call this method to get the same behavior.
+#if(TM16XX_OPT_SHADOWRAM)
+  if(address>=TM16XX_SHADOWRAM_SIZE)
+    return(true);   // not in shadow RAM, always send
+  uint16_t uBit=bit(address);
+  if((_uShadowValid & uBit) && _btShadowRam[address]==data)
+  {
+    _dwWritesSuppressed++;
+    return(false);
+  }
+  _btShadowRam[address]=data;
+  _uShadowValid|=uBit;
+  if(_fBuffered)
+  {
+    _uShadowDirty|=uBit;
+    return(false);
+  }
+  _dwWritesPerformed++;
+#endif
+  return(true);
+}
+
 byte TM16xx::receive()
 {
   byte temp = 0;
 
+#if(TM16XX_OPT_SPI)
+  if(_pSPI)   // while MOSI sends 0xFF via the resistor, the chip can pull DIO low
+    return(_pSPI->transfer(0xFF));
+#endif
+
   // Pull-up on
   pinMode(dataPin, INPUT);
-  digitalWrite(dataPin, HIGH);
+  dataWrite(HIGH);
 
   for (int i = 0; i < 8; i++) {
     temp >>= 1;
 
-    digitalWrite(clockPin, LOW);
+    clockWrite(LOW);
     bitDelay();		// NOTE: on TM1637 reading keys should be slower than 250Khz (see datasheet p3)
 
-    if (digitalRead(dataPin)) {
+    if (dataRead()) {
       temp |= 0x80;
     }
 
-    digitalWrite(clockPin, HIGH);
+    clockWrite(HIGH);
     bitDelay();
   }
 
   // Pull-up off
 #if defined(ARDUINO_ARCH_CH32)
-  digitalWrite(dataPin, LOW);   // MMOLE 250814: CH32 is sensitive of order
+  dataWrite(LOW);   // MMOLE 250814: CH32 is sensitive of order
   pinMode(dataPin, OUTPUT);
 #else
   pinMode(dataPin, OUTPUT);
-  digitalWrite(dataPin, LOW);
+  dataWrite(LOW);
 #endif
   return temp;
 }
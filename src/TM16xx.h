@@ -52,10 +52,92 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define TM16XX_CMD_MODE_7GRID 0x03    // TM1628, TM1668: 4x13 - 7x10, TM1624: 4x14 - 7x11, TM1618: 4x8 - 7x5
 // TM1617 has 14 addresses (00-0D) but only uses GRID1, GRID2 and GRID7. For mode 7x3 instead of 8x2 it uses command MODE_7GRID.
 
+// Shadow display RAM
+// When enabled the base class keeps a copy of the display memory of the chip. Writing data that is already
+// shown is skipped. In buffered mode sendData() only updates that copy and marks the changed bytes as dirty.
+// flush() then sends all changed data in a single auto-increment burst (as clearDisplay() does).
+// Most TM16xx chips have up to 16 bytes of display memory (e.g. TM1638: 8x2, TM1640: 16x1, TM1668: 7x2).
+// Instead of flush(), service() can be called from loop() to send the changed data in small time slices.
+// Chips using their own protocol (TM1650, TM1652) override service(). TM1680, HT16K33 and TM1621/TM1622 keep their own copy.
+#ifndef TM16XX_OPT_SHADOWRAM
+  #if defined(__AVR_ATtiny85__) ||  defined(__AVR_ATtiny45__) ||  defined(__AVR_ATtiny13__) ||  defined(__AVR_ATtiny44__) ||  defined(__AVR_ATtiny84__)
+    #define TM16XX_OPT_SHADOWRAM 0      // preserve flash and RAM on small MCUs
+  #else
+    #define TM16XX_OPT_SHADOWRAM 1
+  #endif
+#endif
+#define TM16XX_SHADOWRAM_SIZE 16         // NOTE: max 16, as the dirty and valid bitmaps are 16-bit
+#define TM16XX_SERVICE_BYTES 4           // default number of bytes sent per call of service()
+
+// Background refresh
+// In buffered mode tick() can be called from a timer interrupt (or a FreeRTOS task on ESP32) to send the changed
+// display data one byte per call. The sketch then only changes memory and is not delayed by sending display data.
+// Background refresh uses the common TM16xx protocol (e.g. TM1637, TM1638, TM1640, TM1668, TM16xxIC).
+#ifndef TM16XX_OPT_BACKGROUND
+  #define TM16XX_OPT_BACKGROUND TM16XX_OPT_SHADOWRAM
+#endif
+#define TM16XX_TICK_IDLE 0               // states of the background refresh
+#define TM16XX_TICK_ADDRESS 1
+#define TM16XX_TICK_DATA 2
+#define TM16XX_TICK_BYTES 4              // ESP32 background task: bytes sent per task activation (each millisecond)
+
+// I2C chips (TM1680, HT16K33) keep their own copy of the display memory, as they have more than 16 bytes.
+#define TM16XX_I2C_CLOCK 100000L         // default I2C clock, most I2C chips also support 400kHz
+
+// Fast GPIO
+// When enabled the bit-banging methods write directly to the GPIO registers instead of using digitalWrite().
+// Supported on AVR, ESP32, RP2040 and CH32, other MCUs will still use digitalWrite(). See TM16xxGPIO.h
+#ifndef TM16XX_OPT_FASTGPIO
+  #define TM16XX_OPT_FASTGPIO 0
+#endif
+#if(TM16XX_OPT_FASTGPIO)
+  #include "TM16xxGPIO.h"
+#endif
+
+// Hardware SPI
+// 3-wire chips that clock LSB-first (e.g. TM1638, TM1628, TM1668, TM1629) can use hardware SPI in mode 3 instead of bit-banging.
+// To use it, set TM16XX_OPT_SPI to 1 in TM16xx.h or via a build flag (-DTM16XX_OPT_SPI=1) and call setSPI() in setup().
+// This requires the SPI library. 2-wire chips (e.g. TM1637, TM1640, TM1650) don't support it.
+#ifndef TM16XX_OPT_SPI
+  #define TM16XX_OPT_SPI 0
+#endif
+#if(TM16XX_OPT_SPI)
+  #include <SPI.h>
+#endif
+#define TM16XX_SPI_CLOCK 1000000L     // TM16xx chips support clock speeds up to 1MHz
+
+// Brightness fade
+// Next to setupDisplay() (intensity 0-7) the intensity can be set using the native levels of the chip: 8 levels for most
+// chips, 16 levels for TM1652, TM1680 and HT16K33. Level 0 is off. fadeTo() changes the level in the specified time.
+// The fade proceeds each time service() is called and only sends a command when the level changes.
+#ifndef TM16XX_OPT_FADE
+  #if defined(__AVR_ATtiny85__) ||  defined(__AVR_ATtiny45__) ||  defined(__AVR_ATtiny13__) ||  defined(__AVR_ATtiny44__) ||  defined(__AVR_ATtiny84__)
+    #define TM16XX_OPT_FADE 0      // preserve flash and RAM on small MCUs
+  #else
+    #define TM16XX_OPT_FADE 1
+  #endif
+#endif
+#define TM16XX_EASE_LINEAR 0     // easing of the fade: same step time for each level
+#define TM16XX_EASE_IN 1         // start slow, end fast
+#define TM16XX_EASE_OUT 2        // start fast, end slow
+#define TM16XX_EASE_INOUT 3      // start and end slow
+
 #include "TM16xxFonts.h"
 
+class TM16xxGroup
+{ // Modules that can receive the same command at once, e.g. chips on a shared bus (see TM16xxSharedBus and TM16xxParallel)
+  public:
+    virtual void sendCommand(byte cmd)=0;
+    virtual void setupDisplay(bool active, byte intensity)=0;   // broadcast the display control command, update the level of all modules
+};
+
 class TM16xx
 {
+  friend class TM16xxParallel;   // sends the shadow RAM of multiple modules at once
+  friend class TM16xxSharedBus;  // sends commands to multiple chips at once
+  friend class TM16xxDisplay;    // proceeds the fade of its modules
+  friend class TM16xxMatrixGFX;  // resends complete bit-planes in grayscale mode
+
   public:
     /**
      * Instantiate a TM16xx module specifying data, clock and strobe pins (no strobe on some modules),
@@ -68,6 +150,22 @@ class TM16xx
     /** Set the display (segments and LEDs) active or off and intensity (range from 0-7). */
     virtual void setupDisplay(bool active, byte intensity);
 
+    /** Set multiple modules to the same state in a single pass. Modules of a group get a single broadcasted command */
+    static void setupDisplays(TM16xx *aModules[], byte nModules, bool active, byte intensity);
+
+    /** Number of intensity levels of the chip. Level 0 is off, 1 is the lowest intensity and getLevels() the highest */
+    virtual byte getLevels();
+
+    /** Set the display on/off and the intensity using the native levels of the chip (0=off, 1-getLevels()) */
+    virtual void setLevel(byte nLevel);
+    byte getLevel();
+
+#if(TM16XX_OPT_FADE)
+    /** Fade to the specified level (0=off, 1-getLevels()) in uDuration ms. Call service() to proceed the fade */
+    void fadeTo(byte nLevel, uint16_t uDuration, byte nEasing=TM16XX_EASE_LINEAR);
+    bool isFading();
+#endif
+
     /** Set flipped state of the display (every digit is rotated 180 degrees) */
     virtual void setDisplayFlipped(bool fFlipped);
 
@@ -80,6 +178,39 @@ class TM16xx
     /** Use explicit call in setup() or rely on implicit call by sendData(); calls setupDisplay() and clearDisplay() */
     virtual void begin(bool activateDisplay=true, byte intensity=7);
 
+    /** Set buffered mode: display data is kept in shadow RAM until flush() is called (requires TM16XX_OPT_SHADOWRAM) */
+    virtual void setBuffered(bool fBuffered=true);
+    virtual bool isBuffered();      // true when in buffered mode
+
+    /** Send all buffered display data that was changed, using a single auto-increment transaction */
+    virtual void flush();
+
+    /** Send part of the buffered display data: at most nMaxBytes bytes or uMaxMicros us (0=no limit). Returns true when all is sent.
+        Also proceeds a running fade (see fadeTo()) */
+    virtual bool service(byte nMaxBytes=TM16XX_SERVICE_BYTES, uint16_t uMaxMicros=0);
+    virtual bool hasPendingData();   // true when buffered data still needs to be sent
+
+#if(TM16XX_OPT_BACKGROUND)
+    /** Background refresh: send one byte of buffered display data. Call from a timer interrupt. Returns true while busy */
+    virtual bool tick();
+#if defined(ARDUINO_ARCH_ESP32)
+    /** Background refresh using a FreeRTOS task that runs on the same core as loop(). Also sets buffered mode */
+    bool startBackgroundTask(byte nBytesPerTick=TM16XX_TICK_BYTES, uint32_t uStackSize=2048);
+    void stopBackgroundTask();
+#endif
+#endif
+
+#if(TM16XX_OPT_SPI)
+    /** Use hardware SPI for communication (3-wire chips only). Call in setup(), use NULL to return to bit-banging.
+        Returns false when hardware SPI is not used, e.g. for a TM16xxIC configured as 2-wire chip */
+    bool setSPI(SPIClass *pSPI=&SPI, uint32_t uClock=TM16XX_SPI_CLOCK);
+#endif
+
+    /** Statistics of display data writes: performed writes (bytes sent) and suppressed writes (data unchanged) */
+    uint32_t getWritesPerformed();
+    uint32_t getWritesSuppressed();
+    void resetWriteCounters();
+
     /** Set segments of the display */
     virtual void setSegments(byte segments, byte position);
     virtual void setSegments16(uint16_t segments, byte position);   // some modules support more than 8 segments
@@ -112,6 +243,7 @@ class TM16xx
     // Up to 32 key states are supported, but specific chips may support less keys or less combinations
     // The chip specific derived class method will return a 32-bit value representing the state of each key, containing 0 if no key is pressed
     virtual uint32_t getButtons();  // return state of up to 32 keys.
+    virtual byte getKeyScanPeriod();   // msec the chip takes to scan the keys, 0 when unknown (used by TM16xxButtons)
 
   protected:
     virtual void bitDelay();
@@ -121,6 +253,42 @@ class TM16xx
     virtual void sendCommand(byte led);
     virtual void sendData(byte add, byte data);
     virtual byte receive();
+#if(TM16XX_OPT_SPI)
+    virtual bool canUseSPI() { return(true); }    // the 3-wire protocol of send() can be replaced by hardware SPI
+#endif
+    bool shadowWrite(byte address, byte data);   // update shadow RAM, returns true when data should be sent now
+    bool serviceSpent(byte nBytes, byte nMaxBytes, uint32_t tStart, uint16_t uMaxMicros);   // true when service() should stop
+    byte sendRuns(byte nSent, byte nMaxBytes, uint32_t tStart, uint16_t uMaxMicros);   // used by service(), returns bytes sent
+    void shadowCleared();    // used by clearDisplay() to update the shadow RAM
+    void levelSetup(bool active, byte intensity);   // used by setupDisplay() to keep track of the level
+#if(TM16XX_OPT_FADE)
+    void fadeStep();   // used by service() to proceed the fade
+#else
+    inline void fadeStep() {}
+#endif
+
+    // Claim the bus for a transaction of the sketch, called by start() and stop() (see tick())
+#if(TM16XX_OPT_BACKGROUND)
+    void tickHold();
+    void tickRelease();
+    void tickEndRun();
+#else
+    inline void tickHold() {}
+    inline void tickRelease() {}
+#endif
+
+    // Pin access used by the bit-banging methods
+#if(TM16XX_OPT_FASTGPIO)
+    inline void dataWrite(byte level) { _fpData.write(level); }
+    inline void clockWrite(byte level) { _fpClock.write(level); }
+    inline void strobeWrite(byte level) { _fpStrobe.write(level); }
+    inline byte dataRead() { return(_fpData.read()); }
+#else
+    inline void dataWrite(byte level) { digitalWrite(dataPin, level); }
+    inline void clockWrite(byte level) { digitalWrite(clockPin, level); }
+    inline void strobeWrite(byte level) { digitalWrite(strobePin, level); }
+    inline byte dataRead() { return(digitalRead(dataPin)); }
+#endif
 
 #if !defined(max)
 // MMOLE 211229: use c++ function templates to implement our own min/max, as redefining them wont work in newer ESP cores when using certain wifi libraries
@@ -142,15 +310,54 @@ auto min(T x, U y) -> decltype(x>y ? x : y)
 }
 #endif  // !defined(max)
 
+    TM16xxGroup *_pGroup=NULL;   // set when the module is part of a group that can receive broadcasted commands
     byte _maxDisplays=2;   // maximum number of digits (grids), chip-dependent
     byte _maxSegments=8;   // maximum number of segments per display, chip-dependent
     bool flipped=false;    // sets the flipped state of the display;
     bool reversed=false;   // sets the reversed state of the display;
     bool fBeginDone=false; // for implicit begin checking;
     //byte intensitySetup; // TODO: prevent changing of intensity when calling setupDisplay followed by clearDisplay
+    byte _nLevel=0;        // current intensity level (0=off), see setLevel()
+#if(TM16XX_OPT_FADE)
+    bool _fFading=false;
+    byte _nFadeFrom;
+    byte _nFadeTo;
+    byte _nFadeEasing;
+    uint16_t _uFadeDuration;
+    uint32_t _tFadeStart;
+#endif
     byte digits;           // number of digits in the display, module dependent
     byte dataPin;
     byte clockPin;
     byte strobePin;
+#if(TM16XX_OPT_FASTGPIO)
+    TM16xxFastPin _fpData;
+    TM16xxFastPin _fpClock;
+    TM16xxFastPin _fpStrobe;
+#endif
+#if(TM16XX_OPT_SPI)
+    SPIClass *_pSPI=NULL;     // when set, hardware SPI is used instead of bit-banging
+    uint32_t _uSpiClock=TM16XX_SPI_CLOCK;
+#endif
+#if(TM16XX_OPT_SHADOWRAM)
+    byte _btShadowRam[TM16XX_SHADOWRAM_SIZE]={0};  // copy of the display memory of the chip
+    volatile uint16_t _uShadowDirty=0;   // bit per address: changed in shadow RAM, but not yet sent (volatile for tick())
+    uint16_t _uShadowValid=0;   // bit per address: shadow RAM is known to match the display memory
+    bool _fBuffered=false;      // buffered mode: sendData() only updates the shadow RAM
+    uint32_t _dwWritesPerformed=0;
+    uint32_t _dwWritesSuppressed=0;
+#endif
+#if(TM16XX_OPT_BACKGROUND)
+    volatile byte _nTickState=TM16XX_TICK_IDLE;
+    volatile bool _fTickHold=false;   // the sketch is using the bus, tick() should wait
+    bool _fInTick=false;              // set while tick() is sending
+    byte _nTickAddress=0;
+    TM16xx *_pBusNext=NULL;           // next module on a shared bus (ring), see TM16xxSharedBus
+#if defined(ARDUINO_ARCH_ESP32)
+    TaskHandle_t _hTickTask=NULL;
+    byte _nTickBytes=TM16XX_TICK_BYTES;
+    static void tickTask(void *pvModule);
+#endif
+#endif
 };
 #endif
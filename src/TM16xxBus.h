@@ -0,0 +1,284 @@
+/*
+TM16xxBus.h - Compile-time specialized transport for TM16xx chips.
+
+The TM16xx base class uses virtual methods and pins stored as members to communicate with the chip.
+This allows all chips to share the same code, but each bit sent costs virtual calls and runtime checks.
+The TM16xxBus template resolves pins, bit order and ACK handling at compile time. The TM16xxBusChip
+template applies such a bus to a chip class, so that every byte is sent by a single call of fully inlined code.
+
+Usage example:
+    #include <TM1638.h>
+    #include <TM16xxBus.h>
+
+    // TM1638 with DIO=8, CLK=9, STB=7, using 8 digits
+    TM16xxBusChip<TM1638, TM16xxBus<8, 9, 7, TM16XX_IFTYPE_3WSER> > module(8);
+
+    // TM1637 with DIO=2, CLK=3 (no strobe pin), using 4 digits
+    TM16xxBusChip<TM1637, TM16xxBus<2, 3, 2, TM16XX_IFTYPE_2WACK> > module2(4);
+
+Supported interface types:
+    TM16XX_IFTYPE_3WSER   3 wire serial interface like TM1638: DIO/CLK/STB, LSB first
+    TM16XX_IFTYPE_2WSER   2 wire serial interface like TM1640: DIN/CLK, LSB first
+    TM16XX_IFTYPE_2WACK   2 wire interface with ACK like TM1637: DIO/CLK, LSB first
+    TM16XX_IFTYPE_2WACKB  2 wire interface with ACK like TM1650: DAT/CLK, MSB first
+
+The BitDelay parameter specifies the delay in microseconds. Like TM16xx::bitDelay() a delay of 1us is only applied
+on fast MCUs (F_CPU>100MHz). Chips that need more time (e.g. TM1618, TM1628: 5us) should specify it explicitly.
+
+Pin access:
+The bus always writes the pins using TM16xxFastPin (see TM16xxGPIO.h), independent of TM16XX_OPT_FASTGPIO. That option
+only selects the pin access of the regular TM16xx classes. The port and mask of each pin are looked up once, when a chip
+using the bus is constructed. On MCUs not supported by TM16xxFastPin digitalWrite() is used.
+Hardware SPI is not used by the bus: TM16xxBusAdapter replaces start(), stop(), send() and receive(), so calling setSPI()
+on a chip using a bus has no effect and the bus keeps bit-banging the pins.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#ifndef TM16XXBUS_h
+#define TM16XXBUS_h
+
+#include "TM16xxIC.h"   // for the TM16XX_IFTYPE_xxx interface types, will include TM16xx.h
+#include "TM16xxGPIO.h"
+
+template <byte DataPin, byte ClockPin, byte StrobePin, byte Protocol,
+          byte BitDelay = ((Protocol==TM16XX_IFTYPE_2WACK || Protocol==TM16XX_IFTYPE_2WACKB) ? 5 : 1)>
+class TM16xxBus
+{
+  static_assert(Protocol==TM16XX_IFTYPE_3WSER || Protocol==TM16XX_IFTYPE_2WSER || Protocol==TM16XX_IFTYPE_2WACK || Protocol==TM16XX_IFTYPE_2WACKB,
+                "TM16xxBus: unsupported interface type");
+
+  public:
+    static const byte dataPin=DataPin;
+    static const byte clockPin=ClockPin;
+    static const byte strobePin=StrobePin;
+    static const byte protocol=Protocol;
+    static const bool hasStrobe=(Protocol==TM16XX_IFTYPE_3WSER);
+
+    static void begin()
+    { // look up port and mask of the pins, called by the constructor of TM16xxBusAdapter
+      _fpData.begin(DataPin);
+      _fpClock.begin(ClockPin);
+      _fpStrobe.begin(hasStrobe ? StrobePin : 0xFF);
+    }
+
+    static inline void bitDelay()
+    { // Same timing as TM16xx::bitDelay(), but resolved at compile time
+#if F_CPU>100000000
+      if(BitDelay)
+        delayMicroseconds(BitDelay);
+#else
+      if(BitDelay>1)
+        delayMicroseconds(BitDelay);
+#endif
+    }
+
+    static inline void start()
+    {
+      if(Protocol==TM16XX_IFTYPE_2WSER)
+      { // TM1640: when CLK is high, DIN becomes low from high
+        _fpData.write(LOW);
+        _fpClock.write(LOW);
+        bitDelay();
+      }
+      else if(Protocol==TM16XX_IFTYPE_2WACKB)
+      { // TM1650: like I2C, data goes low while clock is high, then clock goes low
+        _fpData.write(HIGH);
+        _fpClock.write(HIGH);
+        bitDelay();
+        _fpData.write(LOW);
+        _fpClock.write(LOW);
+        bitDelay();
+      }
+      else
+      { // TM1638: strobe goes low, TM1637: DIO goes low
+        if(Protocol==TM16XX_IFTYPE_3WSER)
+          _fpStrobe.write(LOW);
+        else
+          _fpData.write(LOW);
+        bitDelay();
+      }
+    }
+
+    static inline void stop()
+    {
+      if(Protocol==TM16XX_IFTYPE_3WSER)
+      {
+        _fpStrobe.write(HIGH);
+        bitDelay();
+      }
+      else if(Protocol==TM16XX_IFTYPE_2WSER)
+      { // TM1640: when CLK is high, DIN becomes high from low
+        _fpClock.write(HIGH);
+        _fpData.write(HIGH);
+        bitDelay();
+      }
+      else
+      { // TM1637/TM1650: clock goes high, then DIO goes high
+        if(Protocol==TM16XX_IFTYPE_2WACK)
+        {
+          _fpData.write(LOW);
+          _fpClock.write(LOW);
+        }
+        else
+        {
+          _fpClock.write(LOW);
+          _fpData.write(LOW);
+        }
+        bitDelay();
+        _fpClock.write(HIGH);
+        _fpData.write(HIGH);
+        bitDelay();
+      }
+    }
+
+    static inline void send(byte data)
+    {
+      for(byte i = 0; i < 8; i++)
+      {
+        _fpClock.write(LOW);
+        bitDelay();
+        if(Protocol==TM16XX_IFTYPE_2WACKB)
+        { // TM1650 expects MSB first
+          _fpData.write(data & 0x80 ? HIGH : LOW);
+          data <<= 1;
+        }
+        else
+        {
+          _fpData.write(data & 1 ? HIGH : LOW);
+          data >>= 1;
+        }
+        if(Protocol!=TM16XX_IFTYPE_2WACKB)
+          bitDelay();
+        _fpClock.write(HIGH);
+        bitDelay();
+      }
+      bitDelay();		// NOTE: TM1638 specifies a Twait between bytes of minimal 1us.
+
+      if(Protocol==TM16XX_IFTYPE_2WSER)
+      { // TM1640 wants data and clock to be low after sending the data
+        _fpClock.write(LOW);
+        _fpData.write(LOW);
+        bitDelay();
+      }
+      else if(Protocol==TM16XX_IFTYPE_2WACK || Protocol==TM16XX_IFTYPE_2WACKB)
+      { // TM1637 and TM1650 confirm reception using an ACK
+        if(Protocol==TM16XX_IFTYPE_2WACKB)
+          bitDelay();
+        readAck();
+      }
+    }
+
+    static inline byte receive()
+    {
+      byte temp = 0;
+      if(Protocol==TM16XX_IFTYPE_2WACKB)
+        _fpClock.write(LOW);
+      pinMode(DataPin, INPUT);
+      _fpData.write(HIGH);    // pull-up on
+
+      for(byte i = 0; i < 8; i++)
+      {
+        if(Protocol==TM16XX_IFTYPE_2WACKB)
+        { // TM1650 sends MSB first, data is valid while clock is high
+          temp <<= 1;
+          _fpClock.write(HIGH);
+          bitDelay();
+          if(_fpData.read())
+            temp |= 0x01;
+          _fpClock.write(LOW);
+        }
+        else
+        {
+          temp >>= 1;
+          _fpClock.write(LOW);
+          bitDelay();
+          if(_fpData.read())
+            temp |= 0x80;
+          _fpClock.write(HIGH);
+        }
+        bitDelay();
+      }
+
+      if(Protocol==TM16XX_IFTYPE_2WACKB)
+        readAck(true);
+      else
+      { // pull-up off
+#if defined(ARDUINO_ARCH_CH32)
+        _fpData.write(LOW);   // MMOLE 250814: CH32 is sensitive of order
+        pinMode(DataPin, OUTPUT);
+#else
+        pinMode(DataPin, OUTPUT);
+        _fpData.write(LOW);
+#endif
+      }
+      return temp;
+    }
+
+  private:
+    static TM16xxFastPin _fpData;
+    static TM16xxFastPin _fpClock;
+    static TM16xxFastPin _fpStrobe;
+
+    static inline void readAck(bool fReceived=false)
+    { // read the acknowledgement (method derived from https://github.com/avishorp/TM1637 using pins in output mode when writing)
+      _fpClock.write(LOW);
+      pinMode(DataPin, INPUT);
+      if(Protocol==TM16XX_IFTYPE_2WACKB && fReceived)
+        _fpData.write(HIGH);
+      bitDelay();
+      _fpClock.write(HIGH);
+      bitDelay();
+      byte ack = _fpData.read();
+      if(Protocol==TM16XX_IFTYPE_2WACKB && fReceived)
+        _fpClock.write(LOW);    // TM1650 ends the ACK after receiving with the clock low
+      if (ack == 0)
+        _fpData.write(LOW);
+      pinMode(DataPin, OUTPUT);
+    }
+};
+
+template <byte DataPin, byte ClockPin, byte StrobePin, byte Protocol, byte BitDelay>
+TM16xxFastPin TM16xxBus<DataPin, ClockPin, StrobePin, Protocol, BitDelay>::_fpData;
+template <byte DataPin, byte ClockPin, byte StrobePin, byte Protocol, byte BitDelay>
+TM16xxFastPin TM16xxBus<DataPin, ClockPin, StrobePin, Protocol, BitDelay>::_fpClock;
+template <byte DataPin, byte ClockPin, byte StrobePin, byte Protocol, byte BitDelay>
+TM16xxFastPin TM16xxBus<DataPin, ClockPin, StrobePin, Protocol, BitDelay>::_fpStrobe;
+
+// Chip class using a compile-time bus. The virtual byte level methods of the chip are replaced by the bus methods,
+// which leaves one virtual call per byte instead of several runtime calls per bit.
+// Constructor parameters are passed to the chip class as-is, so this can also be used for classes like TM16xxIC.
+template <class Chip, class Bus>
+class TM16xxBusAdapter : public Chip
+{
+  public:
+    template <typename... Args>
+    TM16xxBusAdapter(Args... args) : Chip(args...) { Bus::begin(); }
+
+  protected:
+    virtual void bitDelay() { Bus::bitDelay(); }
+    virtual void start() { this->tickHold(); Bus::start(); }
+    virtual void stop() { Bus::stop(); this->tickRelease(); }
+    virtual void send(byte data) { Bus::send(data); }
+    virtual byte receive() { return(Bus::receive()); }
+};
+
+// Chip class using a compile-time bus, taking its pins from the bus. Only the other constructor parameters
+// (such as the number of digits) need to be specified.
+template <class Chip, class Bus, bool fStrobe=Bus::hasStrobe>
+class TM16xxBusChip : public TM16xxBusAdapter<Chip, Bus>
+{ // 3-wire chips: DIO/CLK/STB
+  public:
+    template <typename... Args>
+    TM16xxBusChip(Args... args) : TM16xxBusAdapter<Chip, Bus>(Bus::dataPin, Bus::clockPin, Bus::strobePin, args...) {}
+};
+
+template <class Chip, class Bus>
+class TM16xxBusChip<Chip, Bus, false> : public TM16xxBusAdapter<Chip, Bus>
+{ // 2-wire chips: DIO/CLK
+  public:
+    template <typename... Args>
+    TM16xxBusChip(Args... args) : TM16xxBusAdapter<Chip, Bus>(Bus::dataPin, Bus::clockPin, args...) {}
+};
+
+#endif
@@ -54,6 +54,44 @@ void TM16xxButtons::setLongPressTicks(int ticks)
   _longPressTicks = ticks;
 } // setLongPressTicks
 
+#if(TM16XX_OPT_BUTTONS_DEBOUNCE)
+void TM16xxButtons::setDebounce(byte nSamples, byte nInterval)
+{
+  if(nSamples<1) nSamples=1;
+  if(nSamples>bit(TM16XX_BUTTONS_DEBOUNCE_BITS)-1) nSamples=bit(TM16XX_BUTTONS_DEBOUNCE_BITS)-1;
+  _nDebounceSamples=nSamples;
+  setScanInterval(nInterval, _nScanIdle>nInterval ? _nScanIdle : nInterval);
+  for(_nDebounceBits=0; nSamples>>_nDebounceBits; _nDebounceBits++);   // counters only need the bits to count up to nSamples
+  memset(_adwDebounceCount, 0, sizeof(_adwDebounceCount));
+} // setDebounce
+
+uint32_t TM16xxButtons::debounce(uint32_t dwSample)
+{	// Count the consecutive samples of each button that differ from its debounced state. The counters of the other
+  // buttons are reset. When a counter reaches the number of samples, the debounced state of that button toggles.
+  uint32_t dwDelta=dwSample ^ _dwButtons;
+  uint32_t dwCarry=dwDelta;
+  uint32_t dwReached=dwDelta;
+  for(byte n=0; n<_nDebounceBits; n++)
+  {
+    uint32_t dwCount=_adwDebounceCount[n];
+    _adwDebounceCount[n]=(dwCount ^ dwCarry) & dwDelta;    // increment, or reset when equal to the debounced state
+    dwCarry&=dwCount;
+    dwReached&=(_nDebounceSamples & bit(n)) ? _adwDebounceCount[n] : ~_adwDebounceCount[n];
+  }
+  for(byte n=0; n<_nDebounceBits; n++)
+    _adwDebounceCount[n]&=~dwReached;
+  return(_dwButtons ^ dwReached);
+}
+#endif
+
+void TM16xxButtons::setScanInterval(byte nActive, byte nIdle)
+{
+  if(nActive==TM16XX_BUTTONS_SCAN_CHIP)
+    nActive=_pTM16xx->getKeyScanPeriod() ? _pTM16xx->getKeyScanPeriod() : TM16XX_BUTTONS_SCAN_ACTIVE;
+  _nScanActive=nActive;
+  _nScanIdle=(nIdle<nActive ? nActive : nIdle);
+} // setScanInterval
+
 #if(TM16XX_OPT_BUTTONS_EVENT)
 // set function for release event
 void TM16xxButtons::attachEventHandler(callbackTM16xxButtonsEvent newFunction)
@@ -96,6 +134,78 @@ void TM16xxButtons::attachDuringLongPress(callbackTM16xxButtons newFunction)
 {
   _duringLongPressFunc = newFunction;
 } // attachDuringLongPress
+
+#if(TM16XX_OPT_BUTTONS_REPEAT)
+// set function for repeat event
+void TM16xxButtons::attachRepeat(callbackTM16xxButtons newFunction)
+{
+  _repeatFunc = newFunction;
+} // attachRepeat
+
+// set function for chord event
+void TM16xxButtons::attachChord(callbackTM16xxButtons newFunction)
+{
+  _chordFunc = newFunction;
+} // attachChord
+#endif
+#endif
+
+#if(TM16XX_OPT_BUTTONS_REPEAT)
+void TM16xxButtons::setRepeat(uint16_t uDelay, uint16_t uInterval, byte nAccel, uint16_t uMinInterval)
+{
+  _uRepeatDelay=uDelay;
+  _uRepeatInterval=(uInterval ? uInterval : 1);
+  _nRepeatAccel=(nAccel>15 ? 15 : nAccel);
+  _uRepeatMinInterval=(uMinInterval ? uMinInterval : 1);
+} // setRepeat
+
+byte TM16xxButtons::addChord(uint32_t dwButtons)
+{
+  if(_nChords>=TM16XX_BUTTONS_MAXCHORDS || !dwButtons)
+    return(TM16XX_BUTTONS_SLOT_NOTFOUND);
+  _adwChords[_nChords]=dwButtons;
+  return(_nChords++);
+} // addChord
+
+void TM16xxButtons::clearChords(void)
+{
+  _nChords=0;
+  _btChordsMatched=0;
+} // clearChords
+
+void TM16xxButtons::startRepeat(byte nSlot, uint16_t now)
+{ // the button was pressed: the first repeat follows after the delay
+  _ButtonSlots[nSlot].repeatTime=now+_uRepeatDelay;
+  _ButtonSlots[nSlot].repeatInterval=_uRepeatInterval;
+}
+
+void TM16xxButtons::tickRepeat(byte nSlot, uint16_t now)
+{ // Fire the repeat event when due. The next repeat is scheduled from now, so a slow loop doesn't cause a burst.
+  TM16xxButtonSlot &slot=_ButtonSlots[nSlot];
+  if(!_uRepeatDelay || (int16_t)(now-slot.repeatTime)<0)
+    return;
+  fireEvent(TM16XX_BUTTONS_EVENT_REPEAT, slot.button, now);
+  slot.repeatTime=now+slot.repeatInterval;
+  uint16_t uShorter=slot.repeatInterval-((uint32_t)slot.repeatInterval*_nRepeatAccel>>4);
+  slot.repeatInterval=(uShorter<_uRepeatMinInterval ? _uRepeatMinInterval : uShorter);
+}
+
+void TM16xxButtons::tickChords(uint32_t dwButtons, uint16_t now)
+{ // Compare the (debounced) buttons with each chord. The event is fired when all buttons of the chord become pressed.
+  for(byte n=0; n<_nChords; n++)
+  {
+    if((dwButtons & _adwChords[n])==_adwChords[n])
+    {
+      if(!(_btChordsMatched & bit(n)))
+      {
+        _btChordsMatched|=bit(n);
+        fireEvent(TM16XX_BUTTONS_EVENT_CHORD, n, now);
+      }
+    }
+    else
+      _btChordsMatched&=~bit(n);
+  }
+}
 #endif
 
 // For active buttons we use slots to track the state
@@ -142,7 +252,7 @@ int TM16xxButtons::getPressedTicks(byte nButton)
 {
   nButton=findSlot(nButton);
   if(nButton==TM16XX_BUTTONS_SLOT_NOTFOUND) return(0);
-  return((_ButtonSlots[nButton].stopTime - _ButtonSlots[nButton].startTime));		// uint16_t subtraction may overflow, but is still fine   0x01 - 0xFC = 0x05
+  return((uint16_t)(_ButtonSlots[nButton].stopTime - _ButtonSlots[nButton].startTime));		// uint16_t subtraction may overflow, but is still fine when cast back to uint16_t  0x01 - 0xFC = 0x05
 }
 
 void TM16xxButtons::reset(void)
@@ -154,15 +264,97 @@ void TM16xxButtons::reset(void)
 	  _ButtonSlots[n].startTime = 0;
 	  _ButtonSlots[n].stopTime = 0;
 	}
+  _dwTracked=0;
 }
 
+void TM16xxButtons::fireEvent(byte btEvent, byte nButton, uint16_t now)
+{ // Put the event in the queue and call the attached callback function
+  // The indexes are accessed using acquire/release ordering, so neither the compiler nor the CPU moves the accesses
+  // of the event across the update of the index that hands it over to pollEvent(). Volatile alone doesn't do that.
+#if(TM16XX_OPT_BUTTONS_QUEUE)
+  byte nHead=_nQueueHead;
+  if(btEvent!=TM16XX_BUTTONS_EVENT_LONGPRESSBUSY && (byte)(nHead-__atomic_load_n(&_nQueueTail, __ATOMIC_ACQUIRE))<TM16XX_BUTTONS_QUEUESIZE)
+  {
+    TM16xxButtonEvent &event=_aQueue[nHead%TM16XX_BUTTONS_QUEUESIZE];
+    event.button=nButton;
+    event.event=btEvent;
+    event.time=now;
+    __atomic_store_n(&_nQueueHead, (byte)(nHead+1), __ATOMIC_RELEASE);    // publish the event after it is written
+  }
+#else
+  (void)now;
+#endif
+#if(TM16XX_OPT_BUTTONS_EVENT)
+  if (_eventFunc)
+    _eventFunc(btEvent, nButton);
+#else
+  callbackTM16xxButtons func=NULL;
+  switch(btEvent)
+  {
+    case TM16XX_BUTTONS_EVENT_RELEASE: func=_releaseFunc; break;
+    case TM16XX_BUTTONS_EVENT_CLICK: func=_clickFunc; break;
+    case TM16XX_BUTTONS_EVENT_DOUBLECLICK: func=_doubleClickFunc; break;
+    case TM16XX_BUTTONS_EVENT_LONGPRESSSTART: func=_longPressStartFunc; break;
+    case TM16XX_BUTTONS_EVENT_LONGPRESSSTOP: func=_longPressStopFunc; break;
+    case TM16XX_BUTTONS_EVENT_LONGPRESSBUSY: func=_duringLongPressFunc; break;
+#if(TM16XX_OPT_BUTTONS_REPEAT)
+    case TM16XX_BUTTONS_EVENT_REPEAT: func=_repeatFunc; break;
+    case TM16XX_BUTTONS_EVENT_CHORD: func=_chordFunc; break;
+#endif
+  }
+  if (func)
+    func(nButton);
+#endif
+}
+
+#if(TM16XX_OPT_BUTTONS_QUEUE)
+bool TM16xxButtons::pollEvent(TM16xxButtonEvent &event)
+{
+  _fQueuePolled=true;
+  byte nTail=_nQueueTail;
+  if(nTail==__atomic_load_n(&_nQueueHead, __ATOMIC_ACQUIRE))
+    return(false);
+  event=_aQueue[nTail%TM16XX_BUTTONS_QUEUESIZE];
+  __atomic_store_n(&_nQueueTail, (byte)(nTail+1), __ATOMIC_RELEASE);    // free the slot after it is read
+  return(true);
+}
+#endif
+
 /**
  * @brief Check input of the configured pin and then advance the finite state
  * machine (FSM).
  */
 uint32_t TM16xxButtons::tick(void)
 {	// update the state of each button and call callback functions as needed
-	uint32_t dwButtons=_pTM16xx->getButtons();
+	// Read the keys at the scan interval, in between the last state is used. Keys that are pressed, tracked or
+	// being debounced are read at the shorter active interval.
+	uint32_t dwActive=_dwButtons | _dwTracked;
+#if(TM16XX_OPT_BUTTONS_DEBOUNCE)
+	for(byte n=0; n<_nDebounceBits; n++)
+		dwActive|=_adwDebounceCount[n];
+#endif
+	byte nInterval=(dwActive ? _nScanActive : _nScanIdle);
+	uint16_t now = (uint16_t) millis();
+	if(!nInterval || (uint16_t)(now-_tScan)>=nInterval)
+	{
+		_tScan=now;
+		uint32_t dwRead=_pTM16xx->getButtons();
+#if(TM16XX_OPT_BUTTONS_DEBOUNCE)
+		if(_nDebounceSamples>1)
+			dwRead=debounce(dwRead);
+#endif
+#if(TM16XX_OPT_BUTTONS_REPEAT)
+		if(dwRead || _btChordsMatched)
+			tickChords(dwRead, now);
+#endif
+		_dwButtons=dwRead;
+	}
+	uint32_t dwButtons=_dwButtons;
+	// Only buttons that are pressed or have a slot with pending state need a tick. Released buttons that are
+	// not tracked have no state to advance. Pressed buttons that are not tracked (yet) may still get a slot.
+	uint32_t dwTick=dwButtons | _dwTracked;
+	if(!dwTick)
+		return(dwButtons);
 #ifdef TM16XX_DEBUG
   Serial.print(F("TM16xxButtons: "));
   Serial.print(dwButtons, HEX);
@@ -179,7 +371,8 @@ uint32_t TM16xxButtons::tick(void)
   // do a tick for each possible button
   for(byte n=0; n<32; n++)
   {
-	  tick(n, dwButtons&bit(n));		// MMOLE 181103: _BV only works on 16-bit values!
+	  if(dwTick&bit(n))
+	    tickButton(n, dwButtons&bit(n), now);		// MMOLE 181103: _BV only works on 16-bit values!
 	  //Serial.print(_state[n]);
 	  //Serial.print(_state[n]);
 	}
@@ -189,9 +382,12 @@ uint32_t TM16xxButtons::tick(void)
   //Serial.print(F("    "));
   Serial.println("");
 #else
-  // do a tick for each possible button
-  for(byte n=0; n<32; n++)  // uint32_t dwButtons has 32 buttons at max 
-	  tick(n, dwButtons&bit(n));		// MMOLE 181103: _BV only works on 16-bit values!
+  // do a tick for each button that needs one
+  for(byte n=0; dwTick; n++, dwTick>>=1)  // uint32_t dwButtons has 32 buttons at max 
+  {
+    if(dwTick&1)
+	    tickButton(n, dwButtons&bit(n), now);		// MMOLE 181103: _BV only works on 16-bit values!
+  }
 #endif
 	return(dwButtons);
 }
@@ -201,43 +397,36 @@ uint32_t TM16xxButtons::tick(void)
  */
 void TM16xxButtons::tick(byte nButtonNum, bool activeLevel)
 {
-  uint16_t now = (uint16_t) millis(); // current (relative) time in msecs. To safe RAM we only use the bottom word (16 bits for instead of 32 for approx. 50 days)
+  tickButton(nButtonNum, activeLevel, (uint16_t) millis()); // current (relative) time in msecs. To safe RAM we only use the bottom word (16 bits for instead of 32 for approx. 50 days)
+}
 
-  // find the slot of the button used, or prepare new slot
-  byte nSlot=findSlot(nButtonNum);
-  if(nSlot==TM16XX_BUTTONS_SLOT_NOTFOUND)
-  { // no slot for same button, find a new one
-    if(!activeLevel) return;    // new slots only get occupied when activated
-//Serial.print(nButtonNum, HEX);
-//Serial.print("@");
-    nSlot=findSlot(TM16XX_BUTTONS_SLOT_UNUSED);
-    if(nSlot==TM16XX_BUTTONS_SLOT_NOTFOUND)
-    {   // no new slot, reuse any slot of state TM16XX_BUTTONS_STATE_START
-//Serial.print("N");
-      nSlot=findSlot(TM16XX_BUTTONS_SLOT_ANYBUTTON, TM16XX_BUTTONS_STATE_START);
-      if(nSlot==TM16XX_BUTTONS_SLOT_NOTFOUND)
-      {   // no more slots!
-//Serial.print("!");
-        return;
-      }
-      else
-      { // found used slot in start state, reuse that slot
-//Serial.print(nSlot, HEX);
-//Serial.print("R");
-        _ButtonSlots[nSlot].button=nButtonNum;
-      }
+void TM16xxButtons::tickButton(byte nButtonNum, bool activeLevel, uint16_t now)
+{
+  // Find the slot of the button used, or prepare new slot. Using a single pass over the slots, a new slot is
+  // preferably an unused slot, otherwise a used slot in state TM16XX_BUTTONS_STATE_START is reused.
+  byte nSlot=TM16XX_BUTTONS_SLOT_NOTFOUND;
+  byte nSlotNew=TM16XX_BUTTONS_SLOT_NOTFOUND;
+  for(byte n=0; n<_nMaxButtons; n++)
+  {
+    if(_ButtonSlots[n].button==nButtonNum)
+    {
+      nSlot=n;
+      break;
     }
-    else
-    { // unused slot found, use it
-//Serial.print(nSlot, HEX);
-//Serial.print("U");
-      _ButtonSlots[nSlot].button=nButtonNum;
+    if(_ButtonSlots[n].button==TM16XX_BUTTONS_SLOT_UNUSED)
+    {
+      if(nSlotNew==TM16XX_BUTTONS_SLOT_NOTFOUND || _ButtonSlots[nSlotNew].button!=TM16XX_BUTTONS_SLOT_UNUSED)
+        nSlotNew=n;
     }
+    else if(_ButtonSlots[n].state==TM16XX_BUTTONS_STATE_START && nSlotNew==TM16XX_BUTTONS_SLOT_NOTFOUND)
+      nSlotNew=n;
   }
-  else
-  {
-//Serial.print(nSlot, HEX);
-//Serial.print("F");
+  if(nSlot==TM16XX_BUTTONS_SLOT_NOTFOUND)
+  { // no slot for same button, use the new one
+    if(!activeLevel || nSlotNew==TM16XX_BUTTONS_SLOT_NOTFOUND)
+      return;    // new slots only get occupied when activated, when there are no more slots the press is ignored
+    nSlot=nSlotNew;
+    _ButtonSlots[nSlot].button=nButtonNum;
   }
 
   // Implementation of the state machine
@@ -248,6 +437,9 @@ void TM16xxButtons::tick(byte nButtonNum, bool activeLevel)
     {
       _ButtonSlots[nSlot].state = TM16XX_BUTTONS_STATE_PRESSED; // step to pressed state
       _ButtonSlots[nSlot].startTime = now; // remember starting time
+#if(TM16XX_OPT_BUTTONS_REPEAT)
+      startRepeat(nSlot, now);
+#endif
     } // if
     break;
 
@@ -256,30 +448,14 @@ void TM16xxButtons::tick(byte nButtonNum, bool activeLevel)
     {
       _ButtonSlots[nSlot].state = TM16XX_BUTTONS_STATE_RELEASED; // step to released state
       _ButtonSlots[nSlot].stopTime = now; // remember stopping time
-#if(TM16XX_OPT_BUTTONS_EVENT)
-      if (_eventFunc)
-        _eventFunc(TM16XX_BUTTONS_EVENT_RELEASE, nButtonNum);
-#else
-      if (_releaseFunc)
-        _releaseFunc(nButtonNum);
-#endif
+      fireEvent(TM16XX_BUTTONS_EVENT_RELEASE, nButtonNum, now);
     }
-    else if ((activeLevel) && ((unsigned long)(now - _ButtonSlots[nSlot].startTime) > _longPressTicks))
+    else if ((activeLevel) && ((uint16_t)(now - _ButtonSlots[nSlot].startTime) > _longPressTicks))
     {
       _ButtonSlots[nSlot].state = TM16XX_BUTTONS_STATE_LPRESS; // step to long press state
       _ButtonSlots[nSlot].stopTime = now; // remember stopping time
-#if(TM16XX_OPT_BUTTONS_EVENT)
-      if (_eventFunc)
-      {
-        _eventFunc(TM16XX_BUTTONS_EVENT_LONGPRESSSTART, nButtonNum);
-        _eventFunc(TM16XX_BUTTONS_EVENT_LONGPRESSBUSY, nButtonNum);
-      }
-#else
-      if (_longPressStartFunc)
-        _longPressStartFunc(nButtonNum);
-      if (_duringLongPressFunc)
-        _duringLongPressFunc(nButtonNum);
-#endif
+      fireEvent(TM16XX_BUTTONS_EVENT_LONGPRESSSTART, nButtonNum, now);
+      fireEvent(TM16XX_BUTTONS_EVENT_LONGPRESSBUSY, nButtonNum, now);
     } else {
       // wait. Stay in this state.
     } // if
@@ -287,25 +463,24 @@ void TM16xxButtons::tick(byte nButtonNum, bool activeLevel)
 
   case TM16XX_BUTTONS_STATE_RELEASED: // waiting for button being pressed the second time or timeout.
 #if(TM16XX_OPT_BUTTONS_EVENT)
-    if ((unsigned long)(now - _ButtonSlots[nSlot].startTime) > _clickTicks)
+    if ((uint16_t)(now - _ButtonSlots[nSlot].startTime) > _clickTicks)
+#elif(TM16XX_OPT_BUTTONS_QUEUE)
+    if ((_doubleClickFunc == NULL && !_fQueuePolled) || (uint16_t)(now - _ButtonSlots[nSlot].startTime) > _clickTicks)
 #else
-    if (_doubleClickFunc == NULL || (unsigned long)(now - _ButtonSlots[nSlot].startTime) > _clickTicks)
+    if (_doubleClickFunc == NULL || (uint16_t)(now - _ButtonSlots[nSlot].startTime) > _clickTicks)
 #endif
     {
       // this was only a single short click
-#if(TM16XX_OPT_BUTTONS_EVENT)
-      if (_eventFunc)
-        _eventFunc(TM16XX_BUTTONS_EVENT_CLICK, nButtonNum);
-#else
-      if (_clickFunc)
-        _clickFunc(nButtonNum);
-#endif
+      fireEvent(TM16XX_BUTTONS_EVENT_CLICK, nButtonNum, now);
       _ButtonSlots[nSlot].state = TM16XX_BUTTONS_STATE_START; // restart.
     }
     else if ((activeLevel))
     {
       _ButtonSlots[nSlot].state = TM16XX_BUTTONS_STATE_DBLPRESS; // step to doubleclick state
       _ButtonSlots[nSlot].startTime = now; // remember starting time
+#if(TM16XX_OPT_BUTTONS_REPEAT)
+      startRepeat(nSlot, now);
+#endif
     } // if
     break;
 
@@ -315,18 +490,8 @@ void TM16xxButtons::tick(byte nButtonNum, bool activeLevel)
       // this was a 2 click sequence.
       _ButtonSlots[nSlot].state = TM16XX_BUTTONS_STATE_START; // restart.
       _ButtonSlots[nSlot].stopTime = now; // remember stopping time
-#if(TM16XX_OPT_BUTTONS_EVENT)
-      if (_eventFunc)
-      {
-        _eventFunc(TM16XX_BUTTONS_EVENT_RELEASE, nButtonNum);
-        _eventFunc(TM16XX_BUTTONS_EVENT_DOUBLECLICK, nButtonNum);
-      }
-#else
-      if (_releaseFunc)
-        _releaseFunc(nButtonNum);
-      if (_doubleClickFunc)
-        _doubleClickFunc(nButtonNum);
-#endif
+      fireEvent(TM16XX_BUTTONS_EVENT_RELEASE, nButtonNum, now);
+      fireEvent(TM16XX_BUTTONS_EVENT_DOUBLECLICK, nButtonNum, now);
     } // if
     break;
 
@@ -335,30 +500,29 @@ void TM16xxButtons::tick(byte nButtonNum, bool activeLevel)
     {
       _ButtonSlots[nSlot].state = TM16XX_BUTTONS_STATE_START; // restart.
       _ButtonSlots[nSlot].stopTime = now; // remember stopping time
-#if(TM16XX_OPT_BUTTONS_EVENT)
-      if (_eventFunc)
-      {
-        _eventFunc(TM16XX_BUTTONS_EVENT_RELEASE, nButtonNum);
-        _eventFunc(TM16XX_BUTTONS_EVENT_LONGPRESSSTOP, nButtonNum);
-      }
-#else
-      if (_releaseFunc)
-        _releaseFunc(nButtonNum);
-      if (_longPressStopFunc)
-        _longPressStopFunc(nButtonNum);
-#endif
+      fireEvent(TM16XX_BUTTONS_EVENT_RELEASE, nButtonNum, now);
+      fireEvent(TM16XX_BUTTONS_EVENT_LONGPRESSSTOP, nButtonNum, now);
     }
     else
     {
       // button is being long pressed
-#if(TM16XX_OPT_BUTTONS_EVENT)
-      if (_eventFunc)
-        _eventFunc(TM16XX_BUTTONS_EVENT_LONGPRESSBUSY, nButtonNum);
-#else
-      if (_duringLongPressFunc)
-        _duringLongPressFunc(nButtonNum);
-#endif
+      fireEvent(TM16XX_BUTTONS_EVENT_LONGPRESSBUSY, nButtonNum, now);
     } // if
 		break;
   } // switch
-} // TM16xxButtons.tick(nButton)
\ No newline at end of file
+
+#if(TM16XX_OPT_BUTTONS_REPEAT)
+  // auto-repeat while held (the state is PRESSED, DBLPRESS or LPRESS)
+  if(activeLevel && _ButtonSlots[nSlot].state!=TM16XX_BUTTONS_STATE_START && _ButtonSlots[nSlot].state!=TM16XX_BUTTONS_STATE_RELEASED)
+    tickRepeat(nSlot, now);
+#endif
+
+  // keep track of the buttons with pending state, so tick() can skip the others
+  if(nButtonNum<32)
+  {
+    if(_ButtonSlots[nSlot].state==TM16XX_BUTTONS_STATE_START)
+      _dwTracked&=~bit(nButtonNum);
+    else
+      _dwTracked|=bit(nButtonNum);
+  }
+} // TM16xxButtons.tickButton(nButton)
\ No newline at end of file
@@ -28,7 +28,7 @@ Partially based on OneButton library by Matthias Hertel. See https://github.com/
 #define TM16XX_OPT_BUTTONS_EVENT 0			// use a single callback function instead of multiple (more flash, less heap)
 
 //
-// NOTE: Each button-slot uses 6 bytes to store button-state and timings.
+// NOTE: Each button-slot uses 6 bytes to store button-state and timings (10 bytes with TM16XX_OPT_BUTTONS_REPEAT).
 //       To minimize RAM or FLASH memory used, the number of button slots and the method of memory allocation can be set here.
 //       Your usage determines what setting is best. If you're low on RAM, or your module has few buttons or only supports
 //       single presses, you can set the number of slots to minimum (eg. 1 or 2).
@@ -48,6 +48,24 @@ Partially based on OneButton library by Matthias Hertel. See https://github.com/
 #endif
 
 
+// Debouncing: a button only changes state after the same level was read in several consecutive samples.
+// The samples of all 32 buttons are integrated at once using vertical counters: bit n of each counter word is
+// a bit of the counter of button n. This takes a handful of bitwise operations per sample for all buttons.
+#ifndef TM16XX_OPT_BUTTONS_DEBOUNCE
+  #if defined(__AVR_ATtiny85__) ||  defined(__AVR_ATtiny45__) ||  defined(__AVR_ATtiny13__) ||  defined(__AVR_ATtiny44__) ||  defined(__AVR_ATtiny84__)
+    #define TM16XX_OPT_BUTTONS_DEBOUNCE 0     // preserve flash and RAM on small MCUs
+  #else
+    #define TM16XX_OPT_BUTTONS_DEBOUNCE 1
+  #endif
+#endif
+#define TM16XX_BUTTONS_DEBOUNCE_BITS 4        // bits per counter, max. number of samples is 2^bits-1
+
+// Key scan interval: the chips scan the keys only every few msec (e.g. TM1650: 7ms). Reading the keys more often
+// only takes bus time. setScanInterval() sets how often tick() reads the keys: faster while keys are pressed, slower when idle.
+#define TM16XX_BUTTONS_SCAN_CHIP 0xFF         // use the key scan period of the chip, or TM16XX_BUTTONS_SCAN_ACTIVE when unknown
+#define TM16XX_BUTTONS_SCAN_ACTIVE 10         // msec between reads while keys are pressed, tracked or being debounced
+#define TM16XX_BUTTONS_SCAN_IDLE 40           // msec between reads while no keys are pressed
+
 #define TM16XX_BUTTONS_SLOT_UNUSED 0xFF
 #define TM16XX_BUTTONS_SLOT_NOTFOUND 0xFF
 #define TM16XX_BUTTONS_SLOT_ANYSTATE 0xFF
@@ -60,13 +78,42 @@ Partially based on OneButton library by Matthias Hertel. See https://github.com/
 #define TM16XX_BUTTONS_STATE_LPRESS 4         // button long pressed
 
 
-#if(TM16XX_OPT_BUTTONS_EVENT)
-  #define TM16XX_BUTTONS_EVENT_RELEASE 10
-  #define TM16XX_BUTTONS_EVENT_CLICK 20
-  #define TM16XX_BUTTONS_EVENT_DOUBLECLICK 30
-  #define TM16XX_BUTTONS_EVENT_LONGPRESSSTART 40
-  #define TM16XX_BUTTONS_EVENT_LONGPRESSSTOP 50
-  #define TM16XX_BUTTONS_EVENT_LONGPRESSBUSY 60
+#define TM16XX_BUTTONS_EVENT_RELEASE 10
+#define TM16XX_BUTTONS_EVENT_CLICK 20
+#define TM16XX_BUTTONS_EVENT_DOUBLECLICK 30
+#define TM16XX_BUTTONS_EVENT_LONGPRESSSTART 40
+#define TM16XX_BUTTONS_EVENT_LONGPRESSSTOP 50
+#define TM16XX_BUTTONS_EVENT_LONGPRESSBUSY 60
+#define TM16XX_BUTTONS_EVENT_REPEAT 70        // auto-repeat while the button is held
+#define TM16XX_BUTTONS_EVENT_CHORD 80         // all buttons of a chord are pressed, the button number is the chord number
+
+// Auto-repeat and chords: while a button is held, repeat events are fired after an initial delay, at an interval
+// that becomes shorter with each repeat. A chord is a combination of buttons (e.g. S1+S8), that fires an event
+// when all of its buttons are pressed. The buttons of the chord also fire their own events.
+// As each button slot then needs 4 more bytes, this option is off by default. Set it to 1 to use setRepeat() and addChord().
+#ifndef TM16XX_OPT_BUTTONS_REPEAT
+  #define TM16XX_OPT_BUTTONS_REPEAT 0     // 1=auto-repeat and chords (more flash, 4 bytes more RAM per button slot)
+#endif
+#define TM16XX_BUTTONS_MAXCHORDS 4            // max. number of chords (max. 8)
+
+// Event queue: tick() also puts the events in a fixed-size ring buffer, to be read using pollEvent().
+// With a single producer (tick) and a single consumer (pollEvent) no locking is needed, so tick() can be called
+// from a timer interrupt or another RTOS task, while loop() reads the events. The indexes are updated using
+// release/acquire ordering (GCC __atomic builtins), also on multi-core MCUs such as ESP32 and RP2040.
+// When the queue is full, new events are dropped. The frequent LONGPRESSBUSY events are not queued.
+#ifndef TM16XX_OPT_BUTTONS_QUEUE
+  #define TM16XX_OPT_BUTTONS_QUEUE 1
+#endif
+#ifndef TM16XX_BUTTONS_QUEUESIZE      // number of events in the queue, must be a power of two, max. 128 (the byte indexes wrap at 256)
+  #if defined(__AVR_ATtiny85__) ||  defined(__AVR_ATtiny45__) ||  defined(__AVR_ATtiny13__) ||  defined(__AVR_ATtiny44__) ||  defined(__AVR_ATtiny84__)
+    #define TM16XX_BUTTONS_QUEUESIZE 4
+  #else
+    #define TM16XX_BUTTONS_QUEUESIZE 8
+  #endif
+#endif
+#if(TM16XX_OPT_BUTTONS_QUEUE)
+static_assert(TM16XX_BUTTONS_QUEUESIZE>0 && (TM16XX_BUTTONS_QUEUESIZE & (TM16XX_BUTTONS_QUEUESIZE-1))==0 && TM16XX_BUTTONS_QUEUESIZE<=128,
+  "TM16XX_BUTTONS_QUEUESIZE must be a power of two, max. 128");
 #endif
 
 // ----- Callback function types -----
@@ -84,6 +131,17 @@ struct TM16xxButtonSlot
   byte state;			      // current state of the button tracked, initially TM16XX_BUTTONS_STATE_START;
   uint16_t startTime;   // time started; will be set in state TM16XX_BUTTONS_STATE_PRESSED
   uint16_t stopTime;    // time stopped; will be set in state TM16XX_BUTTONS_STATE_RELEASED
+#if(TM16XX_OPT_BUTTONS_REPEAT)
+  uint16_t repeatTime;  // time of the next repeat, set when pressed
+  uint16_t repeatInterval;  // current repeat interval, becomes shorter with each repeat
+#endif
+};
+
+struct TM16xxButtonEvent
+{
+  byte button;          // number of the button (0-31)
+  byte event;           // TM16XX_BUTTONS_EVENT_RELEASE, _CLICK, _DOUBLECLICK, _LONGPRESSSTART or _LONGPRESSSTOP
+  uint16_t time;        // time of the event, bottom word of millis()
 };
 
 class TM16xxButtons
@@ -98,6 +156,16 @@ class TM16xxButtons
   // set # millisec after long press is assumed.
   void setLongPressTicks(int ticks);
 
+#if(TM16XX_OPT_BUTTONS_DEBOUNCE)
+  // Set debouncing: a button changes state after nSamples equal samples (1-15, 1=no debouncing).
+  // The buttons are sampled every nInterval msec while debouncing (sets the active scan interval, see setScanInterval).
+  void setDebounce(byte nSamples, byte nInterval=5);
+#endif
+
+  // Read the keys every nActive msec while keys are pressed, tracked or debounced and every nIdle msec otherwise.
+  // In between tick() uses the last state of the keys. Default is 0: the keys are read at every tick.
+  void setScanInterval(byte nActive=TM16XX_BUTTONS_SCAN_CHIP, byte nIdle=TM16XX_BUTTONS_SCAN_IDLE);
+
   // attach functions that will be called when button was pressed in the
   // specified way.
 #if(TM16XX_OPT_BUTTONS_EVENT)
@@ -109,7 +177,26 @@ class TM16xxButtons
   void attachLongPressStart(callbackTM16xxButtons newFunction);
   void attachLongPressStop(callbackTM16xxButtons newFunction);
   void attachDuringLongPress(callbackTM16xxButtons newFunction);
+#if(TM16XX_OPT_BUTTONS_REPEAT)
+  void attachRepeat(callbackTM16xxButtons newFunction);
+  void attachChord(callbackTM16xxButtons newFunction);   // the parameter is the chord number
+#endif
 #endif
+
+#if(TM16XX_OPT_BUTTONS_REPEAT)
+  // Auto-repeat while a button is held: the first repeat after uDelay msec, then every uInterval msec. Each repeat the
+  // interval is shortened by nAccel/16 of the interval (0=constant), down to uMinInterval. Use uDelay 0 to disable.
+  void setRepeat(uint16_t uDelay, uint16_t uInterval, byte nAccel=0, uint16_t uMinInterval=0);
+
+  // Add a chord: a mask with a bit per button, e.g. bit(0)|bit(7) for S1+S8. Returns the chord number or
+  // TM16XX_BUTTONS_SLOT_NOTFOUND when there are too many chords. The chord event is fired once per match.
+  byte addChord(uint32_t dwButtons);
+  void clearChords(void);
+#endif
+  /**
+   * @brief Read the buttons and advance the state of the buttons that are pressed or being tracked.
+   * When no button is pressed or tracked, this only takes reading the buttons and one compare.
+   */
   uint32_t tick(void);
   /**
    * @brief Call this function every time the input level has changed.
@@ -118,6 +205,12 @@ class TM16xxButtons
    */
   void tick(byte nButton, bool level);
 
+#if(TM16XX_OPT_BUTTONS_QUEUE)
+  // Get the oldest event from the queue, returns false when there is none. Does not wait.
+  // Once pollEvent() is used, double clicks are detected as when a doubleclick callback is attached.
+  bool pollEvent(TM16xxButtonEvent &event);
+#endif
+
   bool isPressed(byte nButton);
   bool isLongPressed(byte nButton);
   int getPressedTicks(byte nButton);
@@ -143,6 +236,23 @@ class TM16xxButtons
   callbackTM16xxButtons _longPressStartFunc = NULL;
   callbackTM16xxButtons _longPressStopFunc = NULL;
   callbackTM16xxButtons _duringLongPressFunc = NULL;
+#if(TM16XX_OPT_BUTTONS_REPEAT)
+  callbackTM16xxButtons _repeatFunc = NULL;
+  callbackTM16xxButtons _chordFunc = NULL;
+#endif
+#endif
+
+#if(TM16XX_OPT_BUTTONS_REPEAT)
+  uint16_t _uRepeatDelay=0;
+  uint16_t _uRepeatInterval;
+  uint16_t _uRepeatMinInterval;
+  byte _nRepeatAccel;
+  byte _nChords=0;
+  byte _btChordsMatched=0;    // bit per chord that is currently matched
+  uint32_t _adwChords[TM16XX_BUTTONS_MAXCHORDS];
+  void startRepeat(byte nSlot, uint16_t now);
+  void tickRepeat(byte nSlot, uint16_t now);
+  void tickChords(uint32_t dwButtons, uint16_t now);
 #endif
 
   // These variables that hold information across the upcoming tick calls.
@@ -153,6 +263,25 @@ class TM16xxButtons
 #else
   TM16xxButtonSlot _ButtonSlots[TM16XX_BUTTONS_MAXBUTTONSLOTS];
 #endif
+#if(TM16XX_OPT_BUTTONS_DEBOUNCE)
+  uint32_t debounce(uint32_t dwSample);
+  byte _nDebounceSamples=1;
+  byte _nDebounceBits=0;      // bits used per counter
+  uint32_t _adwDebounceCount[TM16XX_BUTTONS_DEBOUNCE_BITS];   // vertical counters, word n holds bit n of each counter
+#endif
+#if(TM16XX_OPT_BUTTONS_QUEUE)
+  TM16xxButtonEvent _aQueue[TM16XX_BUTTONS_QUEUESIZE];
+  volatile byte _nQueueHead=0;    // next event to write, only changed by tick()
+  volatile byte _nQueueTail=0;    // next event to read, only changed by pollEvent()
+  bool _fQueuePolled=false;
+#endif
+  byte _nScanActive=0;
+  byte _nScanIdle=0;
+  uint16_t _tScan=0;          // time the keys were last read
+  uint32_t _dwButtons=0;      // last (debounced) state of the buttons
+  uint32_t _dwTracked=0;    // bit per button that has a slot in another state than TM16XX_BUTTONS_STATE_START
   byte findSlot(byte nButton, byte nStateFind=TM16XX_BUTTONS_SLOT_ANYSTATE);
+  void tickButton(byte nButton, bool level, uint16_t now);
+  void fireEvent(byte btEvent, byte nButton, uint16_t now);
 };
 #endif
\ No newline at end of file
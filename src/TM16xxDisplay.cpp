@@ -108,16 +108,92 @@ void TM16xxDisplay::sendAsciiCharAt(const byte nPosCombi, char c, bool fDot, con
 void TM16xxDisplay::setIntensity(byte intensity)
 {	// set the intensity of the module; range 0-8, 0=off, 8=brightest
   if(intensity>8) intensity=8;
+#if(TM16XX_OPT_COMBIDISPLAY)
+  // Set all modules in a single pass. Modules on a shared bus get a single broadcasted command.
+  // NOTE: when the inherited class has overloaded setupDisplay() with default extra parameters, 
+  // this will call TM16xx::setupDisplay(), not TM16nn::setupDisplay(). (See TM1652.h)
+  // Solution is to have derived classes use separate method for the call without the extra parameters
+  TM16xx::setupDisplays(_aModules, _nNumModules, intensity!=0, intensity>0 ? intensity-1: 0);
+#else
+	_pTM16xx->setupDisplay(intensity!=0, intensity>0 ? intensity-1: 0);
+#endif
+}
+
+#if(TM16XX_OPT_FADE)
+void TM16xxDisplay::fadeTo(byte intensity, uint16_t uDuration, byte nEasing)
+{ // Fade each module to the level of its chip that matches the intensity (e.g. intensity 4 is level 8 on a TM1680)
+  if(intensity>8) intensity=8;
 #if(TM16XX_OPT_COMBIDISPLAY)
   for(int i=0; i<_nNumModules; i++)
-  { // set the insensity of each individual module
-    // NOTE: when the inherited class has overloaded setupDisplay() with default extra parameters, 
-    // this will call TM16xx::setupDisplay(), not TM16nn::setupDisplay(). (See TM1652.h)
-    // Solution is to have derived classes use separate method for the call without the extra parameters
-  	_aModules[i]->setupDisplay(intensity!=0, intensity>0 ? intensity-1: 0);
+  {
+    byte nLevel=intensity*_aModules[i]->getLevels()/8;
+    _aModules[i]->fadeTo((intensity && !nLevel) ? 1 : nLevel, uDuration, nEasing);
   }
 #else
-	_pTM16xx->setupDisplay(intensity!=0, intensity>0 ? intensity-1: 0);
+  byte nLevel=intensity*_pTM16xx->getLevels()/8;
+  _pTM16xx->fadeTo((intensity && !nLevel) ? 1 : nLevel, uDuration, nEasing);
+#endif
+}
+
+bool TM16xxDisplay::isFading()
+{
+#if(TM16XX_OPT_COMBIDISPLAY)
+  for(int i=0; i<_nNumModules; i++)
+  {
+    if(_aModules[i]->isFading())
+      return(true);
+  }
+  return(false);
+#else
+  return(_pTM16xx->isFading());
+#endif
+}
+#endif
+
+void TM16xxDisplay::setBuffered(bool fBuffered)
+{ // set buffered mode of each module used in the display
+#if(TM16XX_OPT_COMBIDISPLAY)
+  for(int i=0; i<_nNumModules; i++)
+  	_aModules[i]->setBuffered(fBuffered);
+#else
+	_pTM16xx->setBuffered(fBuffered);
+#endif
+}
+
+void TM16xxDisplay::flush()
+{ // send all buffered data of each module
+#if(TM16XX_OPT_COMBIDISPLAY)
+  for(int i=0; i<_nNumModules; i++)
+  	_aModules[i]->flush();
+#else
+	_pTM16xx->flush();
+#endif
+}
+
+bool TM16xxDisplay::service(byte nMaxBytes, uint16_t uMaxMicros)
+{ // Send part of the buffered data (see TM16xx::service()). To stay within the limits only one module is serviced per call.
+  // The next module is serviced once all data of the current module is sent. Returns true when all modules are up to date.
+  // A running fade proceeds on all modules.
+#if(TM16XX_OPT_COMBIDISPLAY)
+  for(int i=0; i<_nNumModules; i++)
+    _aModules[i]->fadeStep();
+  for(int i=0; i<_nNumModules; i++)
+  {
+    if(_aModules[_nServiceModule]->hasPendingData())
+    {
+      _aModules[_nServiceModule]->service(nMaxBytes, uMaxMicros);
+      break;
+    }
+    _nServiceModule=(_nServiceModule+1)%_nNumModules;
+  }
+  for(int i=0; i<_nNumModules; i++)
+  {
+    if(_aModules[i]->hasPendingData())
+      return(false);
+  }
+  return(true);
+#else
+	return(_pTM16xx->service(nMaxBytes, uMaxMicros));
 #endif
 }
 
@@ -33,6 +33,16 @@ class TM16xxDisplay : public Print
   TM16xxDisplay(TM16xx *apTM16xx[], byte nNumModules, byte nNumDigitsTotal);
 #endif
   void setIntensity(byte intensity);		// intensity 0-7, 0=off, 7=bright
+#if(TM16XX_OPT_FADE)
+  // fade to the intensity (0-8, like setIntensity) in uDuration ms, using all levels of the chips; call service() to proceed
+  void fadeTo(byte intensity, uint16_t uDuration, byte nEasing=TM16XX_EASE_LINEAR);
+  bool isFading();
+#endif
+
+  // buffered mode: printing only updates the shadow RAM of the modules, call service() in loop() or flush() to send the data
+  void setBuffered(bool fBuffered=true);
+  void flush();
+  bool service(byte nMaxBytes=TM16XX_SERVICE_BYTES, uint16_t uMaxMicros=0);   // returns true when all modules are up to date
 
   void clear();
 
@@ -69,6 +79,7 @@ class TM16xxDisplay : public Print
   TM16xx *_apTM16xx[1];           // place to hold value when only one module is used
   TM16xx **_aModules;   // pointer to external array of modules
   byte _nNumModules=1;
+  byte _nServiceModule=0;   // module being updated by service()
 #endif
 
  
@@ -0,0 +1,64 @@
+/*
+TM16xxGPIO.cpp - Direct GPIO register access for the bit-banging methods of the TM16xx library.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#include "TM16xx.h"
+#include "TM16xxGPIO.h"
+
+void TM16xxFastPin::begin(byte pin)
+{ // Look up the registers and mask of the pin.
+  // Invalid pins (such as the 255 used by I2C chips) get a dummy register, so writing them does nothing, like digitalWrite().
+#if defined(__AVR__)
+  static volatile uint8_t dummy;
+  uint8_t port=(pin<NUM_DIGITAL_PINS) ? digitalPinToPort(pin) : NOT_A_PIN;
+  if(port==NOT_A_PIN)
+  {
+    _pOut=&dummy;
+    _pIn=&dummy;
+    _mask=0;
+    return;
+  }
+  _pOut=portOutputRegister(port);
+  _pIn=portInputRegister(port);
+  _mask=digitalPinToBitMask(pin);
+#elif defined(ARDUINO_ARCH_ESP32)
+  static volatile uint32_t dummy;
+  _pSet=_pClr=_pIn=&dummy;
+  _mask=0;
+  if(pin>=NUM_DIGITAL_PINS)
+    return;
+  #if defined(digitalPinToGPIONumber)
+  pin=digitalPinToGPIONumber(pin);
+  #endif
+  if(pin<32)
+  {
+    _pSet=(volatile uint32_t *)GPIO_OUT_W1TS_REG;
+    _pClr=(volatile uint32_t *)GPIO_OUT_W1TC_REG;
+    _pIn=(volatile uint32_t *)GPIO_IN_REG;
+    _mask=1UL<<pin;
+  }
+  #if defined(GPIO_OUT1_W1TS_REG)
+  else
+  { // the ESP32 has 40 GPIO pins, the upper pins use the second set of registers
+    _pSet=(volatile uint32_t *)GPIO_OUT1_W1TS_REG;
+    _pClr=(volatile uint32_t *)GPIO_OUT1_W1TC_REG;
+    _pIn=(volatile uint32_t *)GPIO_IN1_REG;
+    _mask=1UL<<(pin-32);
+  }
+  #endif
+#elif defined(ARDUINO_ARCH_RP2040)
+  _mask=(pin<NUM_DIGITAL_PINS) ? 1UL<<pin : 0;
+#elif defined(ARDUINO_ARCH_CH32)
+  static GPIO_TypeDef dummy;
+  _pPort=&dummy;
+  _mask=0;
+  if(pin>=NUM_DIGITAL_PINS)
+    return;
+  _pPort=digitalPinToPort(pin);
+  _mask=digitalPinToBitMask(pin);
+#else
+  _pin=pin;
+#endif
+}
@@ -0,0 +1,95 @@
+/*
+TM16xxGPIO.h - Direct GPIO register access for the bit-banging methods of the TM16xx library.
+
+On most cores digitalWrite() looks up the port and mask of a pin on every call. On AVR that takes about 50 cycles,
+which dominates the time needed to send data to a TM16xx chip. The TM16xxFastPin class looks up the port and mask
+once (in the constructor of the TM16xx object) and then writes directly to the GPIO registers.
+
+Supported: AVR (PORTx/PINx), ESP32 (GPIO out_w1ts/out_w1tc), RP2040 (SIO) and CH32 (BSHR/BCR).
+On other MCUs digitalWrite() is used.
+
+To use it, set TM16XX_OPT_FASTGPIO to 1 in TM16xx.h or via a build flag (-DTM16XX_OPT_FASTGPIO=1).
+The compile-time bus of TM16xxBus.h always uses this class, independent of that option.
+NOTE: fast GPIO also gives a faster clock. On fast MCUs TM16xx::bitDelay() keeps the clock below the 1MHz limit of the chips.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#ifndef TM16XXGPIO_h
+#define TM16XXGPIO_h
+
+#include "Arduino.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+  #include "soc/gpio_reg.h"
+#elif defined(ARDUINO_ARCH_RP2040)
+  #include "hardware/structs/sio.h"
+#endif
+
+class TM16xxFastPin
+{
+  public:
+    void begin(byte pin);   // look up port and mask of the pin; only uses register tables, so it can be called from a constructor
+
+    inline void write(byte level)
+    {
+#if defined(__AVR__)
+      // like digitalWrite() interrupts are disabled during read-modify-write, as an ISR may change other pins of the same port
+      uint8_t oldSREG = SREG;
+      cli();
+      if(level)
+        *_pOut |= _mask;
+      else
+        *_pOut &= ~_mask;
+      SREG = oldSREG;
+#elif defined(ARDUINO_ARCH_ESP32)
+      *(level ? _pSet : _pClr) = _mask;    // write-1-to-set/clear registers don't need read-modify-write
+#elif defined(ARDUINO_ARCH_RP2040)
+      if(level)
+        sio_hw->gpio_set = _mask;
+      else
+        sio_hw->gpio_clr = _mask;
+#elif defined(ARDUINO_ARCH_CH32)
+      if(level)
+        _pPort->BSHR = _mask;
+      else
+        _pPort->BCR = _mask;
+#else
+      digitalWrite(_pin, level);
+#endif
+    }
+
+    inline byte read()
+    {
+#if defined(__AVR__) || defined(ARDUINO_ARCH_ESP32)
+      return((*_pIn & _mask) ? HIGH : LOW);
+#elif defined(ARDUINO_ARCH_RP2040)
+      return((sio_hw->gpio_in & _mask) ? HIGH : LOW);
+#elif defined(ARDUINO_ARCH_CH32)
+      return((_pPort->INDR & _mask) ? HIGH : LOW);
+#else
+      return(digitalRead(_pin));
+#endif
+    }
+
+  private:
+#if defined(__AVR__)
+    volatile uint8_t *_pOut;
+    volatile uint8_t *_pIn;
+    uint8_t _mask;
+#elif defined(ARDUINO_ARCH_ESP32)
+    volatile uint32_t *_pSet;
+    volatile uint32_t *_pClr;
+    volatile uint32_t *_pIn;
+    uint32_t _mask;
+#elif defined(ARDUINO_ARCH_RP2040)
+    uint32_t _mask;
+#elif defined(ARDUINO_ARCH_CH32)
+    GPIO_TypeDef *_pPort;
+    uint32_t _mask;
+#else
+    byte _pin;
+#endif
+};
+
+#endif
@@ -45,6 +45,9 @@ TM16xxIC::TM16xxIC(if_ctrl_tm16xx ctrl, byte dataP, byte clockP, byte strobeP, b
   {
     this->strobePin=dataP;
     digitalWrite(this->strobePin, HIGH);
+#if(TM16XX_OPT_FASTGPIO)
+    _fpStrobe.begin(this->strobePin);
+#endif
   }
 
   // Many TM16xx chips support multiplexing of up to 3 SEG pins to allow using them as GRD instead.
@@ -89,8 +92,9 @@ void TM16xxIC::start()
 {	
   if(_ctrl.if_type==TM16XX_IFTYPE_2WSER)
   {	// TM1640: The starting condition of data input is: when CLK is high, the DIN becomes low from high;
-    digitalWrite(dataPin, LOW);
-    digitalWrite(clockPin, LOW);
+    tickHold();
+    dataWrite(LOW);
+    clockWrite(LOW);
     bitDelay();
   }
   else
@@ -108,42 +112,51 @@ void TM16xxIC::send(byte data)
     // unlike TM1638/TM1668 and TM1640, chips like TM1637 uses an ACK to confirm reception of command/data
     // read the acknowledgement
     // TODO? return the ack?
-    digitalWrite(clockPin, LOW);
+    clockWrite(LOW);
     pinMode(dataPin, INPUT);
     bitDelay();
-    digitalWrite(clockPin, HIGH);
+    clockWrite(HIGH);
     bitDelay();
-    uint8_t ack = digitalRead(dataPin);
+    uint8_t ack = dataRead();
     if (ack == 0)
-      digitalWrite(dataPin, LOW);
+      dataWrite(LOW);
     pinMode(dataPin, OUTPUT);
   }
   else if(_ctrl.if_type==TM16XX_IFTYPE_2WSER)
   { 	// MOLE 180514: TM1640 wants data and clock to be low after sending the data
-    digitalWrite(clockPin, LOW);		// first clock low
-    digitalWrite(dataPin, LOW);			// then data low
+    clockWrite(LOW);		// first clock low
+    dataWrite(LOW);			// then data low
     bitDelay();
   }
 }
 
+#if(TM16XX_OPT_SPI)
+bool TM16xxIC::canUseSPI()
+{ // hardware SPI can only replace the 3-wire serial interface, the other interface types use their own start/stop/ACK sequences
+  return(_ctrl.if_type==TM16XX_IFTYPE_3WSER);
+}
+#endif
+
 void TM16xxIC::stop()
 { // to stop chips like TM1637 expects the clock to go high, when strobing DIO high
   if(_ctrl.if_type==TM16XX_IFTYPE_2WACK)
   {
-    digitalWrite(strobePin, LOW);
-    digitalWrite(clockPin, LOW);
+    strobeWrite(LOW);
+    clockWrite(LOW);
     bitDelay();
-    digitalWrite(clockPin, HIGH);
-    digitalWrite(strobePin, HIGH);
+    clockWrite(HIGH);
+    strobeWrite(HIGH);
     bitDelay();
+    tickRelease();
   }
   else if(_ctrl.if_type==TM16XX_IFTYPE_2WSER)
   { // TM1640: The ending condition is: when CLK is high, the DIN becomes high from low.
     //bitDelay();     // extra delay for RP2040, matrix test showed weird behavior on some TM1640 during stop()
-    digitalWrite(clockPin, HIGH);
+    clockWrite(HIGH);
     //bitDelay();     // extra delay for RP2040, matrix test showed weird behavior on some TM1640 during stop()
-    digitalWrite(dataPin, HIGH);
+    dataWrite(HIGH);
     bitDelay();
+    tickRelease();
   }
   else
     TM16xx::stop();
@@ -160,6 +173,7 @@ void TM16xxIC::setupDisplay(bool active, byte intensity)
 
   // Switch display on/off and set intensity 
   sendCommand(TM16XX_CMD_DISPLAY | (active ? 8 : 0) | min(7, intensity));
+  levelSetup(active, intensity);
 }
 
 uint16_t TM16xxIC::flipSegments16(uint16_t uSegments)
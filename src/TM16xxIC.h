@@ -31,7 +31,7 @@ Made by Maxint R&D. See https://github.com/maxint-rd
 #define TM16XX_IFTYPE_2WACK 6   // 2 wire non-addressable interface with ACK like TM1637: DIO/CLK
 /*TODO*/ #define TM16XX_IFTYPE_0WIRE 0    // 0 wire no interface, only useful for debugging
 /*DONT*/ #define TM16XX_IFTYPE_1WSER 1    // 1 wire serial interface like TM1652: DIN, fixed bitrate 19200
-/*TODO*/ #define TM16XX_IFTYPE_4WSER 4    // 4 wire serial interface like TM1629/TM1623/: DIN/DOU/CLK/STB. Datasheets mention DI shorted to DO becomes DIO => IFTYPE_3WSER, (TODO: test hardware SPI: MOSI/MISO/SCK/SS=COPI/CIPO/SCK/CS)
+/*TODO*/ #define TM16XX_IFTYPE_4WSER 4    // 4 wire serial interface like TM1629/TM1623/: DIN/DOU/CLK/STB. Datasheets mention DI shorted to DO becomes DIO => IFTYPE_3WSER, (hardware SPI: see TM16xx::setSPI(), MOSI->DIN, MISO<-DOUT)
 /*TODO*/ #define TM16XX_IFTYPE_5WSER 5    // 3 wire like TM1649: DIO/SCLK/STB; separate DATA/CLK or BIN0-BIN3 for touch
 /*DONT*/ #define TM16XX_IFTYPE_2WACKB 7   // 2 wire non-addressable interface with ACK like TM1650: DAT/CLK, deviating commands/bitorder/etc
 /*TODO*/ #define TM16XX_IFTYPE_2WI2C 8    // 2 wire I2C addressable interface like TM1680: SDA/SCK
@@ -81,7 +81,7 @@ struct if_ctrl_tm16xx
 #define IC_TM1638  if_ctrl_tm16xx {TM16XX_IFTYPE_3WSER, 1, 8, TM16XX_IC_SEGMUX_0 | TM16XX_IC_SEGBYTES_2, 0x03FF, 4, 0x77}  // SxG:10x8 CC/CA, K:8x3
 #define IC_TM1640  if_ctrl_tm16xx {TM16XX_IFTYPE_2WSER, 1, 16,TM16XX_IC_SEGMUX_0 | TM16XX_IC_SEGBYTES_1, 0x00FF, 0, 0x00}  // SxG: 8x16 CC/CA
 #define IC_TM1668  if_ctrl_tm16xx {TM16XX_IFTYPE_3WSER, 5, 7, TM16XX_IC_SEGMUX_3 | TM16XX_IC_SEGBYTES_2, 0x3BFF, 5, 0x1B}  // SxG: 13x4-10x7 CC/CA, K:10x2; same as TM1628A in smaller package
-/* TODO for TM1623: Test separate DI/DO with hardware SPI,  TM16XX_IFTYPE_4WSER */
+/* TODO for TM1623: Test separate DI/DO with hardware SPI (TM16xx::setSPI()),  TM16XX_IFTYPE_4WSER */
 
 //
 // UNTESTED chips, only based on datasheet information. CHECK BEFORE USE.
@@ -180,6 +180,9 @@ class TM16xxIC : public TM16xx
     virtual void start();
     virtual void stop();
     virtual void send(byte data);
+#if(TM16XX_OPT_SPI)
+    virtual bool canUseSPI();
+#endif
     uint16_t mapSegments16(uint16_t segments, const byte *pMap=NULL);
     uint16_t flipSegments16(uint16_t uSegments);
     if_ctrl_tm16xx _ctrl; // made protected to make it usable by derived classes
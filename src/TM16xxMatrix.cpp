@@ -44,3 +44,19 @@ bool TM16xxMatrix::getPixel(byte nCol, byte nRow)
 {
 	return((_btColumns[nCol]&_BV(nRow))!=0);
 }
+
+void TM16xxMatrix::blit(int16_t nCol, int16_t nRow, TM16xxSprite &sprite, byte nMode)
+{	// Combine the sprite with the offscreen bitmap, column by column. Only changed columns are sent.
+	byte btRows=bit(_nRows)-1;
+	for(byte n=0; n<sprite.getWidth(); n++)
+	{
+		int16_t nX=nCol+n;
+		if(nX<0)
+			continue;
+		if(nX>=_nColumns)
+			break;
+		byte btColumn=(sprite.blitColumn(_btColumns[nX], n, nRow, nMode) & btRows) | (_btColumns[nX] & ~btRows);
+		if(btColumn!=_btColumns[nX])
+			setColumn(nX, btColumn);
+	}
+}
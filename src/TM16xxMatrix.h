@@ -17,6 +17,7 @@ Made by Maxint R&D. See https://github.com/maxint-rd/
 #define _TM16XX_MATRIX_H
 
 #include "TM16xx.h"
+#include "TM16xxSprite.h"
 
 #define TM16XX_MATRIX_MAXCOLUMNS 16
 
@@ -28,6 +29,7 @@ class TM16xxMatrix
 	void setAll(bool fOn);
 	void setPixel(byte nCol, byte nRow, bool fOn);
 	bool getPixel(byte nCol, byte nRow);
+	void blit(int16_t nCol, int16_t nRow, TM16xxSprite &sprite, byte nMode=TM16XX_BLIT_OR);	// left-top of the sprite at nCol, nRow
 	inline byte getNumRows() { return(_nRows); }
 	inline byte getNumColumns() { return(_nColumns); }
 
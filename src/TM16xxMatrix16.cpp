@@ -51,3 +51,19 @@ bool TM16xxMatrix16::getPixel(byte nCol, byte nRow)
 {
 	return((_uColumns[nCol]&bit(nRow))!=0);
 }
+
+void TM16xxMatrix16::blit(int16_t nCol, int16_t nRow, TM16xxSprite &sprite, byte nMode, bool fRender)
+{	// Combine the sprite with the offscreen bitmap, column by column. When rendering only changed columns are sent.
+	uint16_t uRows=(_nRows>=16 ? 0xFFFF : bit(_nRows)-1);
+	for(byte n=0; n<sprite.getWidth(); n++)
+	{
+		int16_t nX=nCol+n;
+		if(nX<0)
+			continue;
+		if(nX>=_nColumns)
+			break;
+		uint16_t uColumn=(sprite.blitColumn(_uColumns[nX], n, nRow, nMode) & uRows) | (_uColumns[nX] & ~uRows);
+		if(uColumn!=_uColumns[nX])
+			setColumn(nX, uColumn, fRender);
+	}
+}
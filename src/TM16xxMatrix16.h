@@ -17,6 +17,7 @@ Made by Maxint R&D. See https://github.com/maxint-rd/
 #define _TM16XX_MATRIX16_H
 
 #include "TM16xx.h"
+#include "TM16xxSprite.h"
 
 #define TM16XX_MATRIX16_MAXCOLUMNS 16
 #define TM16XX_MATRIX16_MAXROWS 16
@@ -30,6 +31,7 @@ class TM16xxMatrix16
 	void render(void);
 	void setPixel(byte nCol, byte nRow, bool fOn, bool fRender=true);
 	bool getPixel(byte nCol, byte nRow);
+	void blit(int16_t nCol, int16_t nRow, TM16xxSprite &sprite, byte nMode=TM16XX_BLIT_OR, bool fRender=true);	// left-top of the sprite at nCol, nRow
 	inline byte getNumRows() { return(_nRows); }
 	inline byte getNumColumns() { return(_nColumns); }
 
@@ -11,73 +11,276 @@ Made by Maxint R&D. See https://github.com/maxint-rd/
 
 #define TM16xxMatrixGFX_swap(a, b) { int16_t t = a; a = b; b = t; }
 
-TM16xxMatrixGFX::TM16xxMatrixGFX(TM16xx *pModule, byte nColumns, byte nRows) : Adafruit_GFX(nRows, nColumns)
+TM16xxMatrixGFX::TM16xxMatrixGFX(TM16xx *pModule, byte nColumns, byte nRows) :
+	TM16xxMatrixGFX(&pModule, nColumns, nRows, 1, 1, NULL, NULL, 0, NULL, NULL, NULL)
 {
-	_nColumns=nColumns;
-	_nRows=nRows;
-	_fMirrorX=false;
-	_fMirrorY=false;
-	
-	// Allocate a module array for just one module
-	_nModules=1;
-	_aModules=(TM16xx **)malloc(sizeof(TM16xx *));
-	_aModules[0]=pModule;
-
-	// An offscreen bitmap is required to set an individual pixel, while retaining the others 
-	// We use dynamic memory allocation for the off-screen bitmap
-	// as different chips support different sizes
-	TM16xxMatrixGFX::bitmapSize = _nColumns;
-  TM16xxMatrixGFX::bitmap = (byte*)malloc(bitmapSize);
-  fillScreen(0);
 }
 
-TM16xxMatrixGFX::TM16xxMatrixGFX(TM16xx *aModules[], byte nColumns, byte nRows, byte nModulesCol, byte nModulesRow) : Adafruit_GFX(nRows*nModulesRow, nColumns*nModulesCol)
+TM16xxMatrixGFX::TM16xxMatrixGFX(TM16xx *aModules[], byte nColumns, byte nRows, byte nModulesCol, byte nModulesRow) :
+	TM16xxMatrixGFX(aModules, nColumns, nRows, nModulesCol, nModulesRow, NULL, NULL, 0, NULL, NULL, NULL)
 {
+}
+
+TM16xxMatrixGFX::TM16xxMatrixGFX(TM16xx *aModules[], byte nColumns, byte nRows, byte nModulesCol, byte nModulesRow,
+		TM16xx **aModulesStatic, byte *pBitmapStatic, byte nPlanesStatic, byte *pLayoutStatic, byte *pLutStatic, byte *pDirtyStatic) :
+	Adafruit_GFX(nRows*nModulesRow, nColumns*nModulesCol)
+{	// Common constructor. The memory is either provided by TM16xxMatrixGFXStatic or allocated when NULL is specified.
 	_nColumns=nColumns;
 	_nRows=nRows;
 	_fMirrorX=false;
 	_fMirrorY=false;
-
-	// Allocate memory to copy pointers to the modules
+	_fStatic=(pBitmapStatic!=NULL);
+#if(TM16XX_OPT_GRAYSCALE)
+	_nPlanesStatic=nPlanesStatic;
+#else
+	(void)nPlanesStatic;
+#endif
+
+	// Copy pointers to the modules
 	_nModules=nModulesRow*nModulesCol;
-	_aModules=(TM16xx **)malloc(_nModules*sizeof(TM16xx *));
+	_aModules=aModulesStatic ? aModulesStatic : (TM16xx **)malloc(_nModules*sizeof(TM16xx *));
 	for(byte n=0; n<_nModules; n++)
 			_aModules[n]=aModules[n];
 
-	// Allocate memory for the memory bitmap
+	// An offscreen bitmap is required to set an individual pixel, while retaining the others 
+	// We use dynamic memory allocation for the off-screen bitmap
+	// as different chips support different sizes
 	_nModulesRow=nModulesRow;
 	_nModulesCol=nModulesCol;
 	TM16xxMatrixGFX::bitmapSize = _nColumns*nModulesRow*nModulesCol;	// assume 8 rows per byte
-  TM16xxMatrixGFX::bitmap = (byte*)malloc(bitmapSize);
+  TM16xxMatrixGFX::bitmap = pBitmapStatic ? pBitmapStatic : (byte*)malloc(bitmapSize);
+	_pDirty=pDirtyStatic ? pDirtyStatic : (byte*)malloc((bitmapSize+7)/8);
   fillScreen(0);
+
+	// The module layout (module at each position) also allows rotating a single module using setModulePosition().
+	// A layout entry holds up to 64 modules, more modules are always shown in the order given.
+	if(_nModules<=TM16XX_MATRIXGFX_MAXLAYOUT)
+		_pLayout=pLayoutStatic ? pLayoutStatic : (byte *)malloc(_nModules);
+	if(_pLayout)
+	{
+		for(byte n=0; n<_nModules; n++)
+			_pLayout[n]=n;
+	}
+	if(_nModules>1 && _nModulesRow<=16 && _nModulesCol<=16)
+	{	// coordinate translation tables, a table entry holds up to 16 modules per row or column
+		_pLut=pLutStatic ? pLutStatic : (byte *)malloc(WIDTH+HEIGHT);
+		buildLut();
+	}
+}
+
+TM16xxMatrixGFX::~TM16xxMatrixGFX()
+{
+	if(_fStatic)
+		return;
+	free(_aModules);
+	free(bitmap);
+	free(_pDirty);
+	free(_pLayout);
+	free(_pLut);
 }
 
 void TM16xxMatrixGFX::setIntensity(byte intensity)
-{	// set the intensity of all modules
+{	// set the intensity of all modules in a single pass, modules on a shared bus get a single broadcasted command
+	TM16xx::setupDisplays(_aModules, _nModules, true, intensity);
+}
+
+void TM16xxMatrixGFX::setBuffered(bool fBuffered)
+{	// set buffered mode of all modules
+	_fBuffered=fBuffered;
+#if(TM16XX_OPT_SHADOWRAM)
+	if(_pParallel)
+	{	// the modules remain buffered, write() sends the data using the parallel bus
+		if(!fBuffered)
+			_pParallel->flush();
+		return;
+	}
+#endif
+	for(byte n=0; n<_nModules; n++)
+			_aModules[n]->setBuffered(fBuffered);
+}
+
+#if(TM16XX_OPT_SHADOWRAM)
+void TM16xxMatrixGFX::setParallel(TM16xxParallel *pParallel)
+{	// Send the data of all modules in parallel. The bus should be made using the same modules as this matrix.
+	// The bus puts the modules in buffered mode. Unless setBuffered() is used, write() will flush the bus.
+	_pParallel=pParallel;
+}
+#endif
+
+#if(TM16XX_OPT_GRAYSCALE)
+bool TM16xxMatrixGFX::setGrayscale(byte nBits, uint16_t uPlaneMicros)
+{	// Allocate a bit-plane for each bit. The bitmap itself is the first plane, so monochrome mode needs no extra memory.
+	if(nBits<1) nBits=1;
+	if(nBits>TM16XX_GRAYSCALE_MAXBITS) nBits=TM16XX_GRAYSCALE_MAXBITS;
+	if(_fStatic)
+	{	// the planes are part of the static bitmap
+		if(nBits>_nPlanesStatic)
+			return(false);
+	}
+	else
+	{
+		byte *pPlanes=(byte*)realloc(bitmap, nBits*bitmapSize);
+		if(!pPlanes)
+			return(false);
+		bitmap=pPlanes;
+	}
+	_nPlanes=nBits;
+	_nPlane=0;
+	_uPlaneMicros=uPlaneMicros;
+	_uPlaneCount=0;
+	_tPlane=micros();
+	fillScreen(0);
+	if(nBits>1)
+		setBuffered(true);	// send each plane in a single burst
+	return(true);
+}
+
+bool TM16xxMatrixGFX::serviceGrayscale()
+{	// Show the next bit-plane when the current plane was shown long enough. Plane n is shown 2^n times as long as plane 0.
+	// The next plane is due at a fixed time after the previous one, so the time spent sending doesn't change the weights.
+	if(_nPlanes<2)
+		return(false);
+	if(_uPlaneMicros)
+	{
+		uint32_t tNow=micros();
+		uint32_t uShow=(uint32_t)_uPlaneMicros<<_nPlane;
+		if(tNow-_tPlane<uShow)
+			return(false);
+		_tPlane+=uShow;
+		if(tNow-_tPlane>((uint32_t)_uPlaneMicros<<_nPlanes))
+			_tPlane=tNow;		// more than a full cycle behind, start over
+	}
+	else
+	{	// called from a timer: count the calls
+		if(++_uPlaneCount<bit(_nPlane))
+			return(false);
+		_uPlaneCount=0;
+	}
+	_nPlane=(_nPlane+1)%_nPlanes;
+	writePlane(bitmap+_nPlane*bitmapSize);
+	return(true);
+}
+#endif
+
+void TM16xxMatrixGFX::flush()
+{	// send all buffered data of all modules
+#if(TM16XX_OPT_SHADOWRAM)
+	if(_pParallel)
+	{
+		_pParallel->flush();
+		return;
+	}
+#endif
+	for(byte n=0; n<_nModules; n++)
+			_aModules[n]->flush();
+}
+
+bool TM16xxMatrixGFX::service(byte nMaxBytes, uint16_t uMaxMicros)
+{	// Send part of the buffered data (see TM16xx::service()). To stay within the limits only one module is serviced per call.
+	// The next module is serviced once all data of the current module is sent. Returns true when all modules are up to date.
+	// Using a parallel bus all modules are serviced at once.
+#if(TM16XX_OPT_SHADOWRAM)
+	if(_pParallel)
+		return(_pParallel->service(nMaxBytes, uMaxMicros));
+#endif
+	for(byte n=0; n<_nModules; n++)
+	{
+		if(_aModules[_nServiceModule]->hasPendingData())
+		{
+			_aModules[_nServiceModule]->service(nMaxBytes, uMaxMicros);
+			break;
+		}
+		_nServiceModule=(_nServiceModule+1)%_nModules;
+	}
 	for(byte n=0; n<_nModules; n++)
-			_aModules[n]->setupDisplay(true, intensity);
+	{
+		if(_aModules[n]->hasPendingData())
+			return(false);
+	}
+	return(true);
 }
 
 void TM16xxMatrixGFX::setMirror(bool fMirrorX, bool fMirrorY)	// fMirrorX=false, fMirrorY=false
 {
 	_fMirrorX=fMirrorX;
 	_fMirrorY=fMirrorY;
+	buildLut();
+}
+
+void TM16xxMatrixGFX::setRotation(uint8_t r)
+{
+	Adafruit_GFX::setRotation(r);
+	buildLut();
+}
+
+bool TM16xxMatrixGFX::setModulePosition(byte nModule, byte nPosition, byte nRotation)
+{	// Show the module at the specified position (left-top to right-bottom), rotated nRotation*90 degrees clockwise.
+	// Modules can only be rotated 90 or 270 degrees when they have as many rows as columns.
+	if(!_pLayout || nModule>=_nModules || nPosition>=_nModules || nRotation>3 || ((nRotation&1) && _nRows!=_nColumns))
+		return(false);
+	_pLayout[nPosition]=(nRotation<<6)|nModule;
+	return(true);
+}
+
+void TM16xxMatrixGFX::setSerpentine(bool fRotate)
+{	// Set the layout of modules that are chained in a zigzag: the first row left to right, the second row right to left,
+	// and so on. Often the modules of every second row are then upside down.
+	for(byte nRow=0; nRow<_nModulesCol; nRow++)
+	{
+		for(byte nCol=0; nCol<_nModulesRow; nCol++)
+		{
+			if(nRow&1)
+				setModulePosition(nRow*_nModulesRow+_nModulesRow-1-nCol, nRow*_nModulesRow+nCol, fRotate ? 2 : 0);
+			else
+				setModulePosition(nRow*_nModulesRow+nCol, nRow*_nModulesRow+nCol, 0);
+		}
+	}
+}
+
+void TM16xxMatrixGFX::buildLut()
+{	// Precompute the translation of the x and y coordinates for the current rotation and mirroring. Each entry has the
+	// module position along the canvas axis (high nibble) and the coordinate within the module (low nibble).
+	// The tables are only used for up to 16 modules per row or column, see the constructor.
+	// The first _width entries are for x, followed by _height entries for y. When rotated 90 or 270 degrees,
+	// x is translated to the canvas y-axis and vice versa.
+	if(!_pLut)
+		return;
+	for(int16_t n=0; n<_width+_height; n++)
+	{
+		int16_t x=(n<_width ? n : 0);
+		int16_t y=(n<_width ? 0 : n-_width);
+		convertToCanvas(x, y);
+		if((n<_width) == !(rotation&1))
+			_pLut[n]=((x/_nRows)<<4) | (x%_nRows);
+		else
+			_pLut[n]=((y/_nColumns)<<4) | (y%_nColumns);
+	}
 }
 
 
 void TM16xxMatrixGFX::fillScreen(uint16_t color)
 {	// set the offscreen bitmap to the specified color
+#if(TM16XX_OPT_GRAYSCALE)
+	if(_nPlanes>1)
+	{	// set each plane to the bit of the level
+		if(color>=bit(_nPlanes)) color=bit(_nPlanes)-1;
+		for(byte p=0; p<_nPlanes; p++)
+			memset(bitmap+p*bitmapSize, (color & bit(p)) ? 0xff : 0, bitmapSize);
+		return;		// the planes are all written by serviceGrayscale(), no need to mark changes
+	}
+#endif
   memset(bitmap, color ? 0xff : 0, bitmapSize);
+	if(_pDirty)
+		memset(_pDirty, 0xff, (bitmapSize+7)/8);
 }
 
-bool TM16xxMatrixGFX::convertToMemPos(int16_t &x, int16_t &y)
-{	// Convert x/y coordinates to bitmap memory position (array with rows of 8 pixels per byte)
-	// Given coordinates are passed by reference and changed to the required range
-	// Returns false if coordinates fall outside of canvas after processing rotation
+void TM16xxMatrixGFX::convertToCanvas(int16_t &x, int16_t &y)
+{	// Convert x/y coordinates to the unrotated canvas, applying rotation and mirroring.
+	// Coordinates outside of the canvas are converted as well, so the corners of a rectangle remain corners.
 	if (rotation)
 	{
 		// Implement Adafruit's rotation.
-		byte tmp;
+		int16_t tmp;
 		if ( rotation >= 2 ) {										// rotation == 2 || rotation == 3
 			x = _width - 1 - x;
 		}
@@ -91,63 +294,76 @@ bool TM16xxMatrixGFX::convertToMemPos(int16_t &x, int16_t &y)
 		}
 	}
 
-	if ( x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT ) {
-		// Ignore pixels outside the canvas.
-		return(false);
-	}
-
-/*		// TODO?: support for different module orientaton and layout? (currently only left-top to right-bottom)
-	// Translate the x, y coordinate according to the layout of the
-	// displays. They can be ordered and rotated (0, 90, 180, 270).
-
-	byte display = matrixPosition[(x >> 3) + hDisplays * (y >> 3)];
-	x &= 0b111;
-	y &= 0b111;
-
-	byte r = matrixRotation[display];
-	if ( r >= 2 ) {										   // 180 or 270 degrees
-		x = 7 - x;
-	}
-	if ( r == 1 || r == 2 ) {				     // 90 or 180 degrees
-		y = 7 - y;
-	}
-	if ( r & 1 ) {     								   // 90 or 270 degrees
-		tmp = x; x = y; y = tmp;
-	}
-
-	byte d = display / hDisplays;
-	x += (display - d * hDisplays) << 3; // x += (display % hDisplays) * 8
-	y += d << 3;												 // y += (display / hDisplays) * 8
-
-	// Update the color bit in our bitmap buffer.
-	byte *ptr = bitmap + x + WIDTH * (y >> 3);
-	byte val = 1 << (y & 0b111);
-
-	if ( color ) {
-		*ptr |= val;
-	}
-	else {
-		*ptr &= ~val;
-	}
-*/
-
 	// mirror display (fMirrorX true for WeMOS mini matrix)
 	if(_fMirrorX)
 		x=WIDTH-x-1;
 	if(_fMirrorY)
 		y=HEIGHT-y-1;
+}
 
-	// Translation for multiple modules.
-	if(_nModules>1)
-	{	// Assume modules are identical and ordered left to right, top to bottom
-		// The columns are stacked in memory in module order
-		uint8_t _nModule=x/_nRows + _nModulesRow*(y/_nColumns);
-		y=y%_nColumns+(_nModule*_nColumns);
-		x=x%_nRows;
+bool TM16xxMatrixGFX::convertToMemPos(int16_t &x, int16_t &y)
+{	// Convert x/y coordinates to bitmap memory position (array with rows of 8 pixels per byte)
+	// Given coordinates are passed by reference and changed to the required range
+	// Returns false if coordinates fall outside of canvas after processing rotation
+	if(_pLut)
+	{	// two table lookups replace rotation, mirroring and the division by the module size
+		if ( x < 0 || x >= _width || y < 0 || y >= _height )
+			return(false);
+		byte nPosX=_pLut[x];		// module position (high nibble) and coordinate within the module (low nibble)
+		byte nPosY=_pLut[_width+y];
+		if(rotation & 1)
+		{
+			byte tmp=nPosX; nPosX=nPosY; nPosY=tmp;
+		}
+		layoutToMemPos(((nPosX&0xF0)<<4) | (nPosX&0x0F), ((nPosY&0xF0)<<4) | (nPosY&0x0F), x, y);
+		return(true);
+	}
+
+	convertToCanvas(x, y);
+	if ( x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT ) {
+		// Ignore pixels outside the canvas.
+		return(false);
 	}
+
+	// Translation for multiple modules (without tables when there was not enough memory).
+	if(_nModules>1)
+		layoutToMemPos(((x/_nRows)<<8) | (x%_nRows), ((y/_nColumns)<<8) | (y%_nColumns), x, y);
+	else
+		layoutToMemPos(x, y, x, y);
 	return(true);
 }
 
+byte TM16xxMatrixGFX::layoutToMemPos(uint16_t nPosX, uint16_t nPosY, int16_t &x, int16_t &y)
+{	// Translate the module position (high byte) and the coordinate within that module (low byte) to bitmap memory position,
+	// using the position and rotation of the module as set by setModulePosition(). Returns the rotation of the module.
+	// The columns of the modules are stacked in memory in module order.
+	byte nModule=(nPosX>>8) + _nModulesRow*(nPosY>>8);
+	byte nRotation=0;
+	if(_pLayout)
+	{
+		nRotation=_pLayout[nModule]>>6;
+		nModule=_pLayout[nModule]&0x3F;
+	}
+	byte lx=nPosX&0xFF, ly=nPosY&0xFF;
+	switch(nRotation)
+	{
+	case 0:
+		x=lx; y=ly;
+		break;
+	case 1:		// 90 degrees clockwise
+		x=ly; y=_nColumns-1-lx;
+		break;
+	case 2:		// 180 degrees
+		x=_nRows-1-lx; y=_nColumns-1-ly;
+		break;
+	case 3:		// 270 degrees
+		x=_nRows-1-ly; y=lx;
+		break;
+	}
+	y+=nModule*_nColumns;
+	return(nRotation);
+}
+
 void TM16xxMatrixGFX::drawPixel(int16_t xx, int16_t yy, uint16_t color)
 {	// set the specified pixel as wanted in the memory
 	// Operating in bytes is faster and takes less code to run. We don't
@@ -161,7 +377,23 @@ void TM16xxMatrixGFX::drawPixel(int16_t xx, int16_t yy, uint16_t color)
 
 	if(!convertToMemPos(x, y))
 		return;
-
+	if(_pDirty)
+		_pDirty[y>>3]|=bit(y&7);		// column y was changed
+
+#if(TM16XX_OPT_GRAYSCALE)
+	if(_nPlanes>1)
+	{	// set the bit of the pixel in each plane, higher colors (e.g. 0xFFFF) are the brightest level
+		if(color>=bit(_nPlanes)) color=bit(_nPlanes)-1;
+		for(byte p=0; p<_nPlanes; p++)
+		{
+			if(color & bit(p))
+				bitmap[y+p*bitmapSize]|=(1<<x);
+			else
+				bitmap[y+p*bitmapSize]&=~(1<<x);
+		}
+		return;
+	}
+#endif
 	if(color)
 	{
 		bitmap[y]|=(1<<x);
@@ -172,6 +404,317 @@ void TM16xxMatrixGFX::drawPixel(int16_t xx, int16_t yy, uint16_t color)
 	}
 }
 
+void TM16xxMatrixGFX::writeBits(int16_t x, int16_t y, uint16_t uBits, uint16_t color, bool fXor)
+{	// Set the pixels of canvas column y that are set in uBits to the color. Bit n of uBits is the pixel at canvas x+n.
+	// When fXor is set, pixels that are on are cleared instead (see writeMem()).
+	// Each module gets the part that falls within its rows using a single mask operation on the byte of that column.
+	if(y<0 || y>=HEIGHT)
+		return;
+	if(x<0)
+	{	// clip left
+		if(x<=-16)
+			return;
+		uBits>>=-x;
+		x=0;
+	}
+	if(x>=WIDTH)
+		return;
+	if(WIDTH-x<16)
+		uBits&=bit(WIDTH-x)-1;		// clip right
+
+	byte level=(color ? 1 : 0);
+	byte nPlanes=1;
+#if(TM16XX_OPT_GRAYSCALE)
+	if(_nPlanes>1)
+	{
+		level=(color>=bit(_nPlanes) ? bit(_nPlanes)-1 : color);
+		nPlanes=_nPlanes;
+	}
+#endif
+	uint16_t nPosY=(_nModules>1 ? ((y/_nColumns)<<8) | (y%_nColumns) : y);		// same translation as convertToMemPos()
+	while(uBits)
+	{
+		uint16_t nPosX=(_nModules>1 ? ((x/_nRows)<<8) | (x%_nRows) : x);
+		byte nChunk=_nRows-(nPosX&0xFF);
+		byte bits=uBits & (bit(nChunk)-1);
+		int16_t nBit, nByte;
+		if(layoutToMemPos(nPosX, nPosY, nBit, nByte)==0)
+			writeMem(nByte, bits<<nBit, level, nPlanes, fXor);
+		else
+		{	// rotated module: set the pixels one by one
+			for(byte n=0; n<nChunk; n++)
+			{
+				if(bits & bit(n))
+				{
+					layoutToMemPos(nPosX+n, nPosY, nBit, nByte);
+					writeMem(nByte, bit(nBit), level, nPlanes, fXor);
+				}
+			}
+		}
+		uBits>>=nChunk;
+		x+=nChunk;
+	}
+}
+
+void TM16xxMatrixGFX::writeMem(int16_t nByte, byte btMask, byte level, byte nPlanes, bool fXor)
+{	// set the bits in btMask of the byte in each plane to the bit of the level
+	// When fXor is set, the pixels in btMask that are on (in any plane) are cleared and the others are set to the level.
+	byte *ptr=bitmap+nByte;
+	if(_pDirty)
+		_pDirty[nByte>>3]|=bit(nByte&7);
+	if(fXor)
+	{
+		byte btOn=0;
+		for(byte p=0; p<nPlanes; p++)
+			btOn|=ptr[p*bitmapSize];
+		for(byte p=0; p<nPlanes; p++, ptr+=bitmapSize)
+		{
+			*ptr&=~btMask;
+			if(level & bit(p))
+				*ptr|=btMask & ~btOn;
+		}
+		return;
+	}
+	for(byte p=0; p<nPlanes; p++, ptr+=bitmapSize)
+	{
+		if(level & bit(p))
+			*ptr|=btMask;
+		else
+			*ptr&=~btMask;
+	}
+}
+
+void TM16xxMatrixGFX::placeBits(int16_t x, int16_t y, byte bits, bool fAlongX, uint16_t color)
+{	// Set the pixels that are set in bits to the color. Bit n is the pixel at x+n (fAlongX) or at y+n.
+	// When the line of pixels falls within a canvas column, they are set using writeBits(), otherwise pixel by pixel.
+	int16_t x0=x, y0=y, x1=fAlongX ? x+7 : x, y1=fAlongX ? y : y+7;
+	convertToCanvas(x0, y0);
+	convertToCanvas(x1, y1);
+	if(y0!=y1)
+	{
+		for(byte n=0; n<8; n++)
+		{
+			if(bits & bit(n))
+				drawPixel(fAlongX ? x+n : x, fAlongX ? y : y+n, color);
+		}
+		return;
+	}
+	if(x1<x0)
+	{	// reversed direction: bit 0 is the last pixel of the canvas column
+		byte rev=0;
+		for(byte n=0; n<8; n++)
+			rev|=((bits>>n)&1)<<(7-n);
+		bits=rev;
+		x0=x1;
+	}
+	writeBits(x0, y0, bits, color);
+}
+
+void TM16xxMatrixGFX::placeColumns(int16_t x, int16_t y, const byte aColumns[], byte nColumns, uint16_t color, bool fXor)
+{	// Set the pixels of up to 8 columns of 8 pixels to the color. Bit n of aColumns[i] is the pixel at x+i, y+n.
+	// When the columns fall within canvas columns (e.g. rotation 1 or 3) each column is written at once. Otherwise the
+	// block is transposed, so each row of up to 8 pixels is written at once. The orientation is determined only once.
+	int16_t x0=x, y0=y, x1=x, y1=y+7, x2=x+7, y2=y;
+	convertToCanvas(x0, y0);		// first pixel
+	convertToCanvas(x1, y1);		// last pixel of the first column
+	convertToCanvas(x2, y2);		// last pixel of the first row
+	bool fAlongX=(y0!=y1);			// the columns run across canvas columns: place the rows
+	int16_t xLast=fAlongX ? x2 : x1;
+	int8_t nStep=fAlongX ? (y1>y0 ? 1 : -1) : (y2>y0 ? 1 : -1);		// canvas column of the next row or column
+	for(byte n=0; n<(fAlongX ? 8 : nColumns); n++, y0+=nStep)
+	{
+		byte bits=0;
+		if(fAlongX)
+		{
+			for(byte i=0; i<nColumns; i++)
+				bits|=((aColumns[i]>>n)&1)<<i;
+		}
+		else
+			bits=aColumns[n];
+		if(!bits)
+			continue;
+		if(xLast<x0)
+		{	// reversed direction: bit 0 is the last pixel of the canvas column
+			byte rev=0;
+			for(byte i=0; i<8; i++)
+				rev|=((bits>>i)&1)<<(7-i);
+			writeBits(xLast, y0, rev, color, fXor);
+		}
+		else
+			writeBits(x0, y0, bits, color, fXor);
+	}
+}
+
+size_t TM16xxMatrixGFX::write(uint8_t c)
+{	// Print a character. Adafruit GFX draws a character of the classic font pixel by pixel using writePixel(). For size 1
+	// the pixels are captured instead and then placed at once using placeColumns(), which sets whole bytes of the bitmap.
+	// Adafruit GFX still handles the cursor, wrapping and the font table. Custom fonts and larger sizes are drawn as usual.
+	if(gfxFont || textsize_x!=1 || textsize_y!=1)
+		return(Adafruit_GFX::write(c));
+	memset(_aCapture, 0, sizeof(_aCapture));
+	memset(_aCaptureBg, 0, sizeof(_aCaptureBg));
+	_fCapture=true;
+	_fCaptured=false;
+	size_t n=Adafruit_GFX::write(c);
+	_fCapture=false;
+	if(!_fCaptured)
+		return(n);		// newline, space or character outside of the display
+
+	// The character was drawn at the previous cursor position. Its columns are at x0..x0+4, the rows at y0..y0+7.
+	int16_t x0=cursor_x-6, y0=cursor_y;
+	byte aFg[5], aBg[5], nShift=y0&7;
+	for(byte i=0; i<5; i++)
+	{	// undo the y&7 indexing of the capture
+		byte fg=_aCapture[(x0+i)&7], bg=_aCaptureBg[(x0+i)&7];
+		aFg[i]=(fg>>nShift) | (fg<<(8-nShift));
+		aBg[i]=(bg>>nShift) | (bg<<(8-nShift));
+	}
+	placeColumns(x0, y0, aFg, 5, textcolor);
+	if(textbgcolor!=textcolor)		// opaque text, the last column was already drawn by Adafruit GFX
+		placeColumns(x0, y0, aBg, 5, textbgcolor);
+	return(n);
+}
+
+void TM16xxMatrixGFX::writePixel(int16_t x, int16_t y, uint16_t color)
+{	// Called by Adafruit GFX, e.g. to draw a character. While capturing (see write(uint8_t)) the pixels of the
+	// character are collected, the 5x8 pixels of a character fall within 8 consecutive values of x and y.
+	if(_fCapture)
+	{
+		_fCaptured=true;
+		if(color==textcolor)
+			_aCapture[x&7]|=bit(y&7);
+		else
+			_aCaptureBg[x&7]|=bit(y&7);
+		return;
+	}
+	drawPixel(x, y, color);
+}
+
+void TM16xxMatrixGFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{	// Fill the rectangle by setting up to 16 pixels of a canvas column at once
+	if(w<0) { x+=w+1; w=-w; }
+	if(h<0) { y+=h+1; h=-h; }
+	if(w==0 || h==0)
+		return;
+	int16_t x0=x, y0=y, x1=x+w-1, y1=y+h-1;
+	convertToCanvas(x0, y0);
+	convertToCanvas(x1, y1);
+	if(x1<x0) TM16xxMatrixGFX_swap(x0, x1);
+	if(y1<y0) TM16xxMatrixGFX_swap(y0, y1);
+	if(x0<0) x0=0;
+	if(y0<0) y0=0;
+	if(x1>=WIDTH) x1=WIDTH-1;
+	if(y1>=HEIGHT) y1=HEIGHT-1;
+	for(int16_t cy=y0; cy<=y1; cy++)
+	{
+		for(int16_t cx=x0; cx<=x1; cx+=16)
+			writeBits(cx, cy, (x1-cx>=15) ? 0xFFFF : bit(x1-cx+1)-1, color);
+	}
+}
+
+void TM16xxMatrixGFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+	fillRect(x, y, 1, h, color);
+}
+
+void TM16xxMatrixGFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+	fillRect(x, y, w, 1, color);
+}
+
+void TM16xxMatrixGFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+{	// draw a bitmap stored in PROGMEM, using the Adafruit GFX format (rows of bytes, MSB is the leftmost pixel)
+	drawBitmapBits(x, y, bitmap, true, w, h, color);
+}
+
+void TM16xxMatrixGFX::drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h, uint16_t color)
+{	// draw a bitmap stored in RAM
+	drawBitmapBits(x, y, bitmap, false, w, h, color);
+}
+
+void TM16xxMatrixGFX::drawBitmapBits(int16_t x, int16_t y, const uint8_t *pBitmap, bool fProgmem, int16_t w, int16_t h, uint16_t color)
+{	// Draw the set pixels of the bitmap in groups of 8. Without rotation a byte of the bitmap is a line along x.
+	// When rotated, lines along x become canvas rows, so 8 rows of a bitmap column are gathered and set at once.
+	int16_t byteWidth=(w+7)/8;
+	if(!(rotation&1))
+	{
+		for(int16_t j=0; j<h; j++)
+		{
+			for(int16_t i=0; i<byteWidth; i++)
+			{
+				byte b=fProgmem ? pgm_read_byte(pBitmap+j*byteWidth+i) : pBitmap[j*byteWidth+i];
+				if(i==byteWidth-1 && (w&7))
+					b&=0xFF<<(8-(w&7));		// skip the padding bits at the end of the row
+				byte bits=0;
+				for(byte n=0; n<8; n++)
+					bits|=((b>>(7-n))&1)<<n;		// MSB first => bit n is pixel x+n
+				if(bits)
+					placeBits(x+i*8, y+j, bits, true, color);
+			}
+		}
+	}
+	else
+	{
+		for(int16_t i=0; i<w; i++)
+		{
+			for(int16_t j=0; j<h; j+=8)
+			{
+				byte bits=0;
+				for(byte n=0; n<8 && j+n<h; n++)
+				{
+					const uint8_t *ptr=pBitmap+(j+n)*byteWidth+i/8;
+					byte b=fProgmem ? pgm_read_byte(ptr) : *ptr;
+					bits|=((b>>(7-(i&7)))&1)<<n;
+				}
+				if(bits)
+					placeBits(x+i, y+j, bits, false, color);
+			}
+		}
+	}
+}
+
+void TM16xxMatrixGFX::blit(int16_t x, int16_t y, TM16xxSprite &sprite, byte nMode, uint16_t color)
+{	// The sprite is placed in blocks of up to 8 columns of 8 pixels using placeColumns(), which also clips them.
+	// When the sprite columns run along the canvas x-axis (rotation 0 or 2), the block is transposed so the
+	// bitmap is still changed a byte at a time. XOR toggles the pixels in the bitmap, in grayscale mode between 0 and color.
+	for(byte n0=0; n0<sprite.getWidth(); n0+=8)
+	{
+		byte nColumns=sprite.getWidth()-n0;
+		if(nColumns>8)
+			nColumns=8;
+		uint16_t aData[8], aMask[8];
+		for(byte i=0; i<nColumns; i++)
+		{
+			aData[i]=sprite.getColumn(n0+i);
+			aMask[i]=sprite.getMask(n0+i);
+		}
+		for(byte nRow=0; nRow<sprite.getHeight(); nRow+=8)
+		{
+			byte aBits[8], aClear[8];
+			for(byte i=0; i<nColumns; i++)
+			{
+				aBits[i]=aData[i]>>nRow;
+				aClear[i]=(aMask[i]>>nRow) & ~aBits[i];		// background pixels within the mask
+			}
+			switch(nMode)
+			{
+				case TM16XX_BLIT_COPY:
+					placeColumns(x+n0, y+nRow, aClear, nColumns, 0);
+					placeColumns(x+n0, y+nRow, aBits, nColumns, color);
+					break;
+				case TM16XX_BLIT_XOR:
+					placeColumns(x+n0, y+nRow, aBits, nColumns, color, true);
+					break;
+				case TM16XX_BLIT_CLEAR:
+					placeColumns(x+n0, y+nRow, aBits, nColumns, 0);
+					break;
+				default:
+					placeColumns(x+n0, y+nRow, aBits, nColumns, color);
+			}
+		}
+	}
+}
+
  // required for scroll support as implemented by Adafruit GFX pull request #60
 uint16_t TM16xxMatrixGFX::getPixel(int16_t x, int16_t y)
 {
@@ -181,17 +724,71 @@ uint16_t TM16xxMatrixGFX::getPixel(int16_t x, int16_t y)
 	if(!convertToMemPos(x, y))
 		return 0;
 
+#if(TM16XX_OPT_GRAYSCALE)
+	uint16_t level=0;
+	for(byte p=0; p<_nPlanes; p++)
+		level|=((bitmap[y+ (x/8)*WIDTH + p*bitmapSize] >> (x%8)) & 0x1)<<p;
+	return(level);
+#else
   return (bitmap[y+ (x/8)*WIDTH] >> (x%8)) & 0x1;
+#endif
 }
 
 void TM16xxMatrixGFX::write()
-{	// write the memory to the display
+{	// Write the columns of the memory that were changed since the previous write() to the display.
+	// When not in buffered mode, the changes of each module are sent as auto-increment runs (see TM16xx::flush()).
+	// A module that was put in buffered mode by the sketch is left buffered, its changes are sent by its own flush().
+#if(TM16XX_OPT_GRAYSCALE)
+	if(_nPlanes>1)
+		return;		// in grayscale mode the planes are written by serviceGrayscale()
+#endif
+#if(TM16XX_OPT_SHADOWRAM)
+	bool fBurst=(!_fBuffered && !_pParallel);
+#endif
+	for(uint8_t n=0;n<_nModules;n++)
+	{
+#if(TM16XX_OPT_SHADOWRAM)
+		bool fModuleBurst=(fBurst && !_aModules[n]->isBuffered());
+		if(fModuleBurst)
+			_aModules[n]->setBuffered(true);
+#endif
+		for(uint8_t i=0;i<_nColumns;i++)
+		{
+			uint16_t nByte=i+(n*_nColumns);
+			if(!_pDirty || (_pDirty[nByte>>3] & bit(nByte&7)))
+				_aModules[n]->setSegments(bitmap[nByte],i);
+		}
+#if(TM16XX_OPT_SHADOWRAM)
+		if(fModuleBurst)
+			_aModules[n]->setBuffered(false);		// sends the changed runs
+#endif
+	}
+	if(_pDirty)
+		memset(_pDirty, 0, (bitmapSize+7)/8);
+#if(TM16XX_OPT_SHADOWRAM)
+	if(_pParallel && !_fBuffered)
+		_pParallel->flush();	// the modules only updated their shadow RAM, send it to all modules at once
+#endif
+}
+
+void TM16xxMatrixGFX::writePlane(byte *pPlane)
+{	// write a plane of the memory to the modules
 	for(uint8_t n=0;n<_nModules;n++)
 	{
+#if(TM16XX_OPT_GRAYSCALE && TM16XX_OPT_SHADOWRAM)
+		// In grayscale mode the complete plane is sent, not only the changed bytes. Each byte is then sent at the same
+		// time after the start of every plane, so the time spent sending doesn't change the on-time of the planes.
+		if(_nPlanes>1)
+			_aModules[n]->_uShadowValid=0;
+#endif
 		for(uint8_t i=0;i<_nColumns;i++)
 		{
-			_aModules[n]->setSegments(bitmap[i+(n*_nColumns)],i);
+			_aModules[n]->setSegments(pPlane[i+(n*_nColumns)],i);
 		}
 	}
+#if(TM16XX_OPT_GRAYSCALE)
+	if(_nPlanes>1)
+		flush();
+#endif
 }
 #endif  // #if has_Adafruit_GFX
@@ -12,6 +12,12 @@ These are the resolutions supported by the most popular TM16xx chips:
 
 The library supports modules with either 8x8 or 8x16 pixels 
 
+TM16xxMatrixGFX allocates its bitmap and tables from the heap. TM16xxMatrixGFXStatic is the same class,
+but with the size given at compile time. All memory is then part of the object, so it shows in the RAM usage
+reported by the compiler and heap fragmentation is avoided. It only provides the storage: the size is still used
+as a runtime value, so drawing is not faster than using TM16xxMatrixGFX. Example for four 8x8 modules in a row:
+    TM16xxMatrixGFXStatic<8, 8, 4, 1> matrix(modules);
+
 Made by Maxint R&D. See https://github.com/maxint-rd/
 
 */
@@ -19,6 +25,8 @@ Made by Maxint R&D. See https://github.com/maxint-rd/
 #define _TM16XX_MATRIXGFX_H
 
 #include "TM16xx.h"
+#include "TM16xxParallel.h"
+#include "TM16xxSprite.h"
 
 #ifdef __has_include
     #if __has_include(<Adafruit_GFX.h>)
@@ -36,6 +44,23 @@ Made by Maxint R&D. See https://github.com/maxint-rd/
 
 
 #define TM16XX_MATRIXGFX_MAXCOLUMNS 16
+#define TM16XX_MATRIXGFX_MAXLAYOUT 64     // max. modules for setModulePosition(), the layout entry has 6 bits for the module
+
+// Grayscale mode
+// The LEDs of the matrix are either on or off. In grayscale mode each pixel has 2-4 bits, stored in separate bit-planes.
+// serviceGrayscale() shows the planes one after the other, each for twice as long as the previous one (bit-plane
+// modulation). The on-time of each pixel is then proportional to its value, giving 4-16 levels of brightness.
+// Each plane is sent completely in a single burst using flush() (or using TM16xxParallel). Sending only the changed
+// bytes would give each byte a different delay per plane, which changes the on-time of the pixels.
+#ifndef TM16XX_OPT_GRAYSCALE
+  #if defined(__AVR_ATtiny85__) ||  defined(__AVR_ATtiny45__) ||  defined(__AVR_ATtiny13__) ||  defined(__AVR_ATtiny44__) ||  defined(__AVR_ATtiny84__)
+    #define TM16XX_OPT_GRAYSCALE 0      // preserve flash and RAM on small MCUs
+  #else
+    #define TM16XX_OPT_GRAYSCALE 1
+  #endif
+#endif
+#define TM16XX_GRAYSCALE_MAXBITS 4
+#define TM16XX_GRAYSCALE_MICROS 500     // default time to show the least significant plane, a 4-bit cycle then takes 7.5ms
 
 #if has_Adafruit_GFX
 class TM16xxMatrixGFX : public Adafruit_GFX
@@ -43,19 +68,65 @@ class TM16xxMatrixGFX : public Adafruit_GFX
  public:
 	TM16xxMatrixGFX(TM16xx *pModule, byte nColumns, byte nRows);
 	TM16xxMatrixGFX(TM16xx *aModules[], byte nColumns, byte nRows, byte nModulesCol, byte nModulesRow);  // module layout left-top to right-bottom
+	virtual ~TM16xxMatrixGFX();
   void setIntensity(byte intensity);		// intensity 0-7, 0=off, 7=bright
   void setMirror(bool fMirrorX=false, bool fMirrorY=false);
+  void setRotation(uint8_t r);
+
+  // Module layout: by default the modules are shown left-top to right-bottom, in the order given to the constructor.
+  // setModulePosition() shows a module at another position (0=left-top) and rotated nRotation*90 degrees clockwise.
+  // Rotating 90 or 270 degrees requires square modules (e.g. 8x8). Supports up to 64 modules, larger displays always
+  // show the modules in the order given. Up to 16 modules per row or column use tables to speed up drawing.
+  bool setModulePosition(byte nModule, byte nPosition, byte nRotation=0);
+  void setSerpentine(bool fRotate=true);   // chained modules: every second row right to left and upside down
   void fillScreen(uint16_t color);
   void drawPixel(int16_t x, int16_t y, uint16_t color);
   uint16_t getPixel(int16_t x, int16_t y); // required for scroll support as implemented by Adafruit GFX pull request #60
+  // faster versions of the Adafruit GFX primitives: these change (parts of) whole bytes of the bitmap at once
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  using Adafruit_GFX::drawBitmap;   // other variants (e.g. with background color) are drawn pixel by pixel
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h, uint16_t color);
+  // text in the classic font (size 1) is placed a glyph column at a time, see write(uint8_t)
+  virtual size_t write(uint8_t c);
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color);
+  // column-major sprite (see TM16xxSprite.h) with left-top at x, y. Sprite columns are along y, also when rotated.
+  void blit(int16_t x, int16_t y, TM16xxSprite &sprite, byte nMode=TM16XX_BLIT_OR, uint16_t color=1);
 
   void write();
 
+  // buffered mode: write() only updates the shadow RAM of the modules, call service() in loop() or flush() to send the data
+  void setBuffered(bool fBuffered=true);
+  void flush();
+  bool service(byte nMaxBytes=TM16XX_SERVICE_BYTES, uint16_t uMaxMicros=0);   // returns true when all modules are up to date
+#if(TM16XX_OPT_SHADOWRAM)
+  // TM1640 modules sharing the CLK pin can be updated in parallel
+  void setParallel(TM16xxParallel *pParallel);
+#endif
+#if(TM16XX_OPT_GRAYSCALE)
+  // grayscale mode: nBits per pixel (1=monochrome, 2-4 gives 4-16 levels), color is the level of the pixel (0-2^nBits-1).
+  // uPlaneMicros is the time the least significant plane is shown, use 0 to count the calls of serviceGrayscale() instead.
+  // Grayscale mode sets buffered mode. Returns false when there is not enough memory.
+  bool setGrayscale(byte nBits, uint16_t uPlaneMicros=TM16XX_GRAYSCALE_MICROS);
+  bool serviceGrayscale();    // call from loop() or a timer, returns true when the next plane was sent
+#endif
+
  protected:
+	// used by TM16xxMatrixGFXStatic to provide the memory, NULL pointers are allocated from the heap
+	TM16xxMatrixGFX(TM16xx *aModules[], byte nColumns, byte nRows, byte nModulesCol, byte nModulesRow,
+		TM16xx **aModulesStatic, byte *pBitmapStatic, byte nPlanesStatic, byte *pLayoutStatic, byte *pLutStatic, byte *pDirtyStatic);
+  bool _fStatic;            // memory is provided by TM16xxMatrixGFXStatic
   byte _nModules;
   byte _nModulesCol;
   byte _nModulesRow;
   TM16xx **_aModules;
+  byte _nServiceModule=0;   // module being updated by service()
+  bool _fBuffered=false;
+#if(TM16XX_OPT_SHADOWRAM)
+  TM16xxParallel *_pParallel=NULL;
+#endif
 
   byte _nColumns;
   byte _nRows;
@@ -63,10 +134,79 @@ class TM16xxMatrixGFX : public Adafruit_GFX
   bool _fMirrorY;
   
   byte *bitmap;
-  byte bitmapSize;
+  uint16_t bitmapSize;      // bytes per plane, more than 255 when using many modules
+  byte *_pLayout=NULL;      // per position: module (bits 0-5) and its rotation (bits 6-7)
+  byte *_pLut=NULL;         // coordinate translation tables for multiple modules, see buildLut()
+  byte *_pDirty=NULL;       // bit per byte (module column) of the bitmap: changed since the last write()
+#if(TM16XX_OPT_GRAYSCALE)
+  byte _nPlanes=1;          // number of bit-planes in the bitmap, plane 0 holds the least significant bit
+  byte _nPlanesStatic;      // planes available in the static bitmap
+  byte _nPlane=0;           // plane being shown
+  uint16_t _uPlaneMicros;
+  uint16_t _uPlaneCount=0;  // calls of serviceGrayscale() the current plane was shown (when _uPlaneMicros is 0)
+  uint32_t _tPlane;         // time the current plane was due
+#endif
+  bool _fCapture=false;     // writePixel() captures the pixels of a character, see write(uint8_t)
+  bool _fCaptured;          // a pixel was captured
+  byte _aCapture[8];        // captured glyph columns (foreground), indexed by x&7 with bit y&7
+  byte _aCaptureBg[8];      // captured glyph columns (background)
   
  private:
+ 	void convertToCanvas(int16_t &x, int16_t &y);
  	bool convertToMemPos(int16_t &x, int16_t &y);
+ 	void buildLut();
+ 	byte layoutToMemPos(uint16_t nPosX, uint16_t nPosY, int16_t &x, int16_t &y);
+ 	void writeMem(int16_t nByte, byte btMask, byte level, byte nPlanes, bool fXor=false);
+ 	void writeBits(int16_t x, int16_t y, uint16_t uBits, uint16_t color, bool fXor=false);
+ 	void placeBits(int16_t x, int16_t y, byte bits, bool fAlongX, uint16_t color);
+ 	void placeColumns(int16_t x, int16_t y, const byte aColumns[], byte nColumns, uint16_t color, bool fXor=false);
+ 	void drawBitmapBits(int16_t x, int16_t y, const uint8_t *pBitmap, bool fProgmem, int16_t w, int16_t h, uint16_t color);
+ 	void writePlane(byte *pPlane);
+};
+
+// Memory of TM16xxMatrixGFXStatic. It is a base class of TM16xxMatrixGFXStatic, so it exists before
+// TM16xxMatrixGFX is constructed. nBits is the number of grayscale bits that can be set using setGrayscale().
+// Only the storage is static, the geometry remains a runtime value of TM16xxMatrixGFX.
+template <byte nColumns, byte nRows, byte nModulesCol, byte nModulesRow, byte nBits>
+struct TM16xxMatrixGFXStorage
+{
+	static constexpr uint16_t nModules=nModulesCol*nModulesRow;
+	static constexpr uint16_t uBitmapSize=(uint16_t)nColumns*nModules;
+	static constexpr uint16_t uLutSize=(nModules>1) ? (uint16_t)nColumns*nModulesCol+nRows*nModulesRow : 1;
+	TM16xx *_aModulesStatic[nModules];
+	alignas(4) byte _aBitmapStatic[uBitmapSize*nBits];
+	byte _aLayoutStatic[nModules];
+	byte _aLutStatic[uLutSize];
+	byte _aDirtyStatic[(uBitmapSize+7)/8];
+};
+
+template <byte nColumns, byte nRows, byte nModulesCol=1, byte nModulesRow=1, byte nBits=1>
+class TM16xxMatrixGFXStatic : private TM16xxMatrixGFXStorage<nColumns, nRows, nModulesCol, nModulesRow, nBits>, public TM16xxMatrixGFX
+{
+	static_assert(nColumns>=1 && nColumns<=TM16XX_MATRIXGFX_MAXCOLUMNS, "TM16xxMatrixGFXStatic: 1-16 columns per module");
+	static_assert(nRows>=1 && nRows<=8, "TM16xxMatrixGFXStatic: 1-8 rows per module");
+	static_assert(nModulesCol>=1 && nModulesCol<=16 && nModulesRow>=1 && nModulesRow<=16, "TM16xxMatrixGFXStatic: 1-16 modules per row or column");
+	static_assert(nModulesCol*nModulesRow<=TM16XX_MATRIXGFX_MAXLAYOUT, "TM16xxMatrixGFXStatic: max. 64 modules");
+#if(TM16XX_OPT_GRAYSCALE)
+	static_assert(nBits>=1 && nBits<=TM16XX_GRAYSCALE_MAXBITS, "TM16xxMatrixGFXStatic: 1-4 grayscale bits");
+#else
+	static_assert(nBits==1, "TM16xxMatrixGFXStatic: grayscale requires TM16XX_OPT_GRAYSCALE");
+#endif
+	typedef TM16xxMatrixGFXStorage<nColumns, nRows, nModulesCol, nModulesRow, nBits> Storage;
+
+ public:
+	static constexpr int16_t width_px=nColumns*nModulesCol;    // size of the display (before rotation)
+	static constexpr int16_t height_px=nRows*nModulesRow;
+
+	TM16xxMatrixGFXStatic(TM16xx *aModules[]) :
+		TM16xxMatrixGFX(aModules, nColumns, nRows, nModulesCol, nModulesRow,
+			Storage::_aModulesStatic, Storage::_aBitmapStatic, nBits, Storage::_aLayoutStatic, Storage::_aLutStatic, Storage::_aDirtyStatic)
+	{
+	}
+	TM16xxMatrixGFXStatic(TM16xx *pModule) : TM16xxMatrixGFXStatic(&pModule)
+	{
+		static_assert(nModulesCol*nModulesRow==1, "TM16xxMatrixGFXStatic: specify an array of modules");
+	}
 };
 #endif  // #if has_Adafruit_GFX
 #endif
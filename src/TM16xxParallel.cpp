@@ -0,0 +1,253 @@
+/*
+TM16xxParallel.cpp - Parallel transmission to multiple TM1640 modules that share the CLK line.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#include "TM16xxParallel.h"
+
+#if(TM16XX_OPT_SHADOWRAM)
+
+#if defined(ARDUINO_ARCH_ESP32)
+  #include "soc/gpio_reg.h"
+#elif defined(ARDUINO_ARCH_RP2040)
+  #include "hardware/structs/sio.h"
+#endif
+
+TM16xxParallel::TM16xxParallel(TM16xx *aModules[], byte nModules)
+{ // The modules are TM1640 (or similar 2-wire) modules, each having its own data pin and all sharing the same clock pin.
+  // The pins are already initialized by the constructors of the modules.
+  _nModules=(nModules>TM16XX_PARALLEL_MAX ? TM16XX_PARALLEL_MAX : nModules);
+  _clockPin=0xFF;
+  if(!_nModules)
+    return;   // empty group, sendCommand() and service() won't do anything
+  for(byte n=0; n<_nModules; n++)
+  {
+    _aModules[n]=aModules[n];
+    _aModules[n]->_pGroup=this;         // TM16xx::setupDisplays() broadcasts the display control command
+    _aModules[n]->setBuffered(true);    // setSegments() only updates the shadow RAM, flush() sends it
+  }
+  _clockPin=_aModules[0]->clockPin;
+#if(TM16XX_OPT_FASTGPIO)
+  _fpClock.begin(_clockPin);
+#endif
+  beginPorts();
+}
+
+void TM16xxParallel::beginPorts()
+{ // Group the data pins per GPIO port, so all data pins of a port can be set using a single write.
+  // Like TM16xxFastPin::begin() this only uses register tables, so it can be called from a constructor.
+  for(byte n=0; n<_nModules; n++)
+  {
+    byte pin=_aModules[n]->dataPin;
+    byte nPort;
+#if defined(__AVR__)
+    volatile uint8_t *pOut=portOutputRegister(digitalPinToPort(pin));
+    for(nPort=0; nPort<_nPorts && _apPortOut[nPort]!=pOut; nPort++);
+    _apPortOut[nPort]=pOut;
+    _aPinMask[n]=digitalPinToBitMask(pin);
+#elif defined(ARDUINO_ARCH_ESP32)
+  #if defined(digitalPinToGPIONumber)
+    pin=digitalPinToGPIONumber(pin);
+  #endif
+    volatile uint32_t *pSet=(volatile uint32_t *)GPIO_OUT_W1TS_REG;
+    volatile uint32_t *pClr=(volatile uint32_t *)GPIO_OUT_W1TC_REG;
+  #if defined(GPIO_OUT1_W1TS_REG)
+    if(pin>=32)
+    { // the ESP32 has 40 GPIO pins, the upper pins use the second set of registers
+      pSet=(volatile uint32_t *)GPIO_OUT1_W1TS_REG;
+      pClr=(volatile uint32_t *)GPIO_OUT1_W1TC_REG;
+    }
+  #endif
+    for(nPort=0; nPort<_nPorts && _apPortSet[nPort]!=pSet; nPort++);
+    _apPortSet[nPort]=pSet;
+    _apPortClr[nPort]=pClr;
+    _aPinMask[n]=1UL<<(pin&0x1F);
+#elif defined(ARDUINO_ARCH_RP2040)
+    nPort=0;    // all pins are in the same SIO bank
+    _aPinMask[n]=1UL<<pin;
+#elif defined(ARDUINO_ARCH_CH32)
+    GPIO_TypeDef *pPort=digitalPinToPort(pin);
+    for(nPort=0; nPort<_nPorts && _apPort[nPort]!=pPort; nPort++);
+    _apPort[nPort]=pPort;
+    _aPinMask[n]=digitalPinToBitMask(pin);
+#else
+    nPort=n;    // no port access, each pin is written using digitalWrite()
+    _aPortPin[nPort]=pin;
+    _aPinMask[n]=1;
+#endif
+    if(nPort>=_nPorts)
+    { // new port
+      _aPortMask[nPort]=0;
+      _nPorts=nPort+1;
+    }
+    _aPinPort[n]=nPort;
+    _aPortMask[nPort]|=_aPinMask[n];
+  }
+}
+
+void TM16xxParallel::portWrite(byte nPort, TM16xxPortMask uSet)
+{ // Set the data pins of a port: pins in uSet high, the other data pins of the port low
+#if defined(__AVR__)
+  // like digitalWrite() interrupts are disabled during read-modify-write, as an ISR may change other pins of the same port
+  uint8_t oldSREG = SREG;
+  cli();
+  *_apPortOut[nPort] = (*_apPortOut[nPort] & ~_aPortMask[nPort]) | uSet;
+  SREG = oldSREG;
+#elif defined(ARDUINO_ARCH_ESP32)
+  *_apPortSet[nPort] = uSet;
+  *_apPortClr[nPort] = _aPortMask[nPort] & ~uSet;
+#elif defined(ARDUINO_ARCH_RP2040)
+  sio_hw->gpio_togl = (sio_hw->gpio_out ^ uSet) & _aPortMask[nPort];    // toggle only the pins that need to change
+#elif defined(ARDUINO_ARCH_CH32)
+  _apPort[nPort]->BSHR = uSet | ((_aPortMask[nPort] & ~uSet)<<16);       // upper half resets pins
+#else
+  digitalWrite(_aPortPin[nPort], uSet ? HIGH : LOW);
+#endif
+}
+
+void TM16xxParallel::dataWrite(const byte aData[], byte uBit)
+{
+  TM16xxPortMask aSet[TM16XX_PARALLEL_MAX]={0};
+  for(byte n=0; n<_nModules; n++)
+  {
+    if(aData[n] & uBit)
+      aSet[_aPinPort[n]]|=_aPinMask[n];
+  }
+  for(byte nPort=0; nPort<_nPorts; nPort++)
+    portWrite(nPort, aSet[nPort]);
+}
+
+void TM16xxParallel::dataWriteAll(byte level)
+{
+  for(byte nPort=0; nPort<_nPorts; nPort++)
+    portWrite(nPort, level ? _aPortMask[nPort] : 0);
+}
+
+void TM16xxParallel::clockWrite(byte level)
+{
+#if(TM16XX_OPT_FASTGPIO)
+  _fpClock.write(level);
+#else
+  digitalWrite(_clockPin, level);
+#endif
+}
+
+void TM16xxParallel::bitDelay()
+{ // same timing as TM16xx::bitDelay()
+#if F_CPU>100000000 || (TM16XX_OPT_FASTGPIO && F_CPU>40000000)
+  delayMicroseconds(1);
+#endif
+}
+
+void TM16xxParallel::start()
+{ // TM1640: when CLK is high, DIN becomes low from high (see TM1640::start())
+  for(byte n=0; n<_nModules; n++)
+    _aModules[n]->tickHold();
+  dataWriteAll(LOW);
+  clockWrite(LOW);
+  bitDelay();
+}
+
+void TM16xxParallel::stop()
+{ // TM1640: when CLK is high, DIN becomes high from low
+  clockWrite(HIGH);
+  dataWriteAll(HIGH);
+  bitDelay();
+  for(byte n=0; n<_nModules; n++)
+    _aModules[n]->tickRelease();
+}
+
+void TM16xxParallel::send(const byte aData[])
+{ // Send one byte to each module, LSB first (see TM16xx::send() and TM1640::send())
+  for(byte uBit=1; uBit; uBit<<=1)
+  {
+    clockWrite(LOW);
+    bitDelay();
+    dataWrite(aData, uBit);
+    bitDelay();
+    clockWrite(HIGH);
+    bitDelay();
+  }
+  bitDelay();
+  clockWrite(LOW);    // TM1640 wants data and clock to be low after sending the data
+  dataWriteAll(LOW);
+  bitDelay();
+}
+
+void TM16xxParallel::sendCommand(byte cmd)
+{
+  if(!_nModules)
+    return;
+  byte aData[TM16XX_PARALLEL_MAX];
+  memset(aData, cmd, _nModules);
+  start();
+  send(aData);
+  stop();
+}
+
+void TM16xxParallel::setupDisplay(bool active, byte intensity)
+{ // Set the intensity and switch the displays on/off (see TM16xx::setupDisplay())
+  sendCommand(TM16XX_CMD_DISPLAY | (active ? 8 : 0) | (intensity>7 ? 7 : intensity));
+  for(byte n=0; n<_nModules; n++)
+    _aModules[n]->levelSetup(active, intensity);    // keep track of the level, e.g. for fadeTo()
+}
+
+void TM16xxParallel::flush()
+{
+  service(0, 0);
+}
+
+bool TM16xxParallel::service(byte nMaxBytes, uint16_t uMaxMicros)
+{ // Send the changed range of the shadow RAM of all modules in one auto-increment transaction.
+  // The range covers the changes of all modules. Modules that have no changes in that range resend their unchanged data.
+  // Like TM16xx::service() the number of addresses or the time per call can be limited. Sending continues at the next call.
+  if(!_nModules)
+    return(true);
+  uint16_t uDirty=0;
+  for(byte n=0; n<_nModules; n++)
+  {
+    _aModules[n]->_uShadowDirty&=bit(_aModules[n]->_maxDisplays)-1;
+    uDirty|=_aModules[n]->_uShadowDirty;
+  }
+  if(!uDirty)
+    return(true);
+  uint32_t tStart=micros();
+  byte nFirst=0, nLast=TM16XX_SHADOWRAM_SIZE-1;
+  while(!(uDirty & bit(nFirst))) nFirst++;
+  while(!(uDirty & bit(nLast))) nLast--;
+
+  byte aData[TM16XX_PARALLEL_MAX];
+  sendCommand(TM16XX_CMD_DATA_AUTO);
+  memset(aData, TM16XX_CMD_ADDRESS | nFirst, _nModules);
+  start();
+  send(aData);
+  for(byte nAddress=nFirst; nAddress<=nLast; nAddress++)
+  {
+    if(nAddress>nFirst && _aModules[0]->serviceSpent(nAddress-nFirst+1, nMaxBytes, tStart, uMaxMicros))
+      break;
+    for(byte n=0; n<_nModules; n++)
+    {
+      TM16xx *pModule=_aModules[n];
+      aData[n]=pModule->_btShadowRam[nAddress];
+      pModule->_uShadowDirty&=~bit(nAddress);
+      pModule->_uShadowValid|=bit(nAddress);
+      pModule->_dwWritesPerformed++;
+    }
+    send(aData);
+  }
+  stop();
+  return(!hasPendingData());
+}
+
+bool TM16xxParallel::hasPendingData()
+{
+  for(byte n=0; n<_nModules; n++)
+  {
+    if(_aModules[n]->hasPendingData())
+      return(true);
+  }
+  return(false);
+}
+
+#endif // #if(TM16XX_OPT_SHADOWRAM)
@@ -0,0 +1,104 @@
+/*
+TM16xxParallel.h - Parallel transmission to multiple TM1640 modules that share the CLK line.
+
+When several 2-wire modules (e.g. TM1640 matrices) each have their own DIN pin, but share the CLK pin, the TM16xxParallel
+class sends the data of all modules in the same clock cycles. Per clock edge the data pins that are on the same GPIO port
+are written at once. Updating all modules then takes about the same time as updating a single module.
+
+The data is taken from the shadow RAM of the modules. The modules are put in buffered mode, so setSegments() and
+TM16xxMatrixGFX::write() only update the shadow RAM. Call flush() or service() to send the changes of all modules.
+When sent separately (e.g. when calling setupDisplay() of one module), the other modules ignore the clock pulses,
+as their DIN line remains high.
+
+Usage example:
+    #include <TM1640.h>
+    #include <TM16xxMatrixGFX.h>
+    #include <TM16xxParallel.h>
+
+    // four TM1640 matrix modules with DIN on pins 2, 3, 4 and 5 and CLK on pin 6
+    TM1640 module1(2, 6), module2(3, 6), module3(4, 6), module4(5, 6);
+    TM16xx *modules[]={&module1, &module2, &module3, &module4};
+    TM16xxParallel bus(modules, 4);
+    TM16xxMatrixGFX matrix(modules, 16, 8, 4, 1);
+
+    void setup() { matrix.setParallel(&bus); }
+
+Port writes are supported on AVR (PORTx), ESP32 (GPIO out_w1ts/out_w1tc), RP2040 (SIO) and CH32 (BSHR).
+On other MCUs digitalWrite() is used for each data pin.
+Requires TM16XX_OPT_SHADOWRAM (not available on ATtiny).
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#ifndef TM16XXPARALLEL_h
+#define TM16XXPARALLEL_h
+
+#include "TM16xx.h"
+
+#if(TM16XX_OPT_SHADOWRAM)
+
+#define TM16XX_PARALLEL_MAX 8        // max number of modules on one clock line
+
+#if defined(__AVR__)
+  typedef uint8_t TM16xxPortMask;
+#elif defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_ARCH_CH32)
+  typedef uint32_t TM16xxPortMask;
+#else
+  typedef uint8_t TM16xxPortMask;    // digitalWrite() per pin
+#endif
+
+class TM16xxParallel : public TM16xxGroup
+{
+  public:
+    /** Specify the modules that share the clock pin. The data and clock pins are taken from the modules */
+    TM16xxParallel(TM16xx *aModules[], byte nModules);
+
+    /** Send the same command to all modules, e.g. to set the intensity */
+    virtual void sendCommand(byte cmd);
+
+    /** Set activation and intensity of all modules using a single command */
+    virtual void setupDisplay(bool active, byte intensity);
+
+    /** Send all changed data in the shadow RAM of the modules, using a single auto-increment transaction */
+    void flush();
+
+    /** Send part of the changed data: at most nMaxBytes addresses or uMaxMicros us (0=no limit). Returns true when all is sent */
+    bool service(byte nMaxBytes=TM16XX_SERVICE_BYTES, uint16_t uMaxMicros=0);
+    bool hasPendingData();
+
+  protected:
+    void bitDelay();
+    void start();
+    void stop();
+    void send(const byte aData[]);   // send one byte to each module
+    void dataWrite(const byte aData[], byte uBit);   // set the data pin of each module to the specified bit of its byte
+    void dataWriteAll(byte level);
+    void clockWrite(byte level);
+
+  private:
+    void beginPorts();
+    void portWrite(byte nPort, TM16xxPortMask uSet);
+    TM16xx *_aModules[TM16XX_PARALLEL_MAX];
+    byte _nModules;
+    byte _clockPin;
+    byte _nPorts=0;
+    byte _aPinPort[TM16XX_PARALLEL_MAX];              // port of the data pin of each module
+    TM16xxPortMask _aPinMask[TM16XX_PARALLEL_MAX];    // bit of the data pin within that port
+    TM16xxPortMask _aPortMask[TM16XX_PARALLEL_MAX];   // all data pins of the port
+#if defined(__AVR__)
+    volatile uint8_t *_apPortOut[TM16XX_PARALLEL_MAX];
+#elif defined(ARDUINO_ARCH_ESP32)
+    volatile uint32_t *_apPortSet[TM16XX_PARALLEL_MAX];
+    volatile uint32_t *_apPortClr[TM16XX_PARALLEL_MAX];
+#elif defined(ARDUINO_ARCH_CH32)
+    GPIO_TypeDef *_apPort[TM16XX_PARALLEL_MAX];
+#elif !defined(ARDUINO_ARCH_RP2040)
+    byte _aPortPin[TM16XX_PARALLEL_MAX];
+#endif
+#if(TM16XX_OPT_FASTGPIO)
+    TM16xxFastPin _fpClock;
+#endif
+};
+
+#endif // #if(TM16XX_OPT_SHADOWRAM)
+#endif
@@ -0,0 +1,179 @@
+/*
+TM16xxSharedBus.cpp - Multiple 3-wire chips on a common DIO/CLK with individual STB lines.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#include "TM16xxSharedBus.h"
+
+TM16xxSharedBus::TM16xxSharedBus(TM16xx *aModules[], byte nModules)
+{ // The constructors of the chip objects all initialized the shared pins the same way, so that needs no change.
+  _nModules=(nModules>TM16XX_SHAREDBUS_MAX ? TM16XX_SHAREDBUS_MAX : nModules);
+  // With an empty bus start(), stop(), sendCommand() and clearDisplay() don't do anything
+  for(byte n=0; n<_nModules; n++)
+  {
+    _aModules[n]=aModules[n];
+    _aModules[n]->_pGroup=this;         // TM16xx::setupDisplays() broadcasts the display control command
+  }
+#if(TM16XX_OPT_BACKGROUND)
+  // link the chips, so the background refresh of all chips waits while the sketch uses one of them
+  for(byte n=0; n<_nModules; n++)
+    _aModules[n]->_pBusNext=_aModules[(n+1)%_nModules];
+#endif
+}
+
+void TM16xxSharedBus::start()
+{ // The first chip handles the bus (background refresh, SPI transaction), the strobes of the others follow
+  if(!_nModules)
+    return;
+  _aModules[0]->start();
+  for(byte n=1; n<_nModules; n++)
+    _aModules[n]->strobeWrite(LOW);
+}
+
+void TM16xxSharedBus::stop()
+{
+  if(!_nModules)
+    return;
+  for(byte n=1; n<_nModules; n++)
+    _aModules[n]->strobeWrite(HIGH);
+  _aModules[0]->stop();
+}
+
+void TM16xxSharedBus::sendCommand(byte cmd)
+{ // Send a command to all chips at once
+  if(!_nModules)
+    return;
+  start();
+  _aModules[0]->send(cmd);
+  stop();
+}
+
+void TM16xxSharedBus::begin(bool activateDisplay, byte intensity)
+{ // Like TM16xx::begin(), but clearing all chips at once. The implicit begin() of the chips is then skipped.
+  // Some chips (e.g. TM1618, TM1628, TM16xxIC) also set their display mode in setupDisplay(), which may differ per chip.
+  // Therefore the setupDisplay() of each chip is called, later calls of setupDisplay() are broadcasted.
+  for(byte n=0; n<_nModules; n++)
+    _aModules[n]->fBeginDone=true;
+  clearDisplay();
+  for(byte n=0; n<_nModules; n++)
+    _aModules[n]->setupDisplay(activateDisplay, intensity);
+}
+
+void TM16xxSharedBus::setupDisplay(bool active, byte intensity)
+{ // Set the intensity and switch the displays on/off (see TM16xx::setupDisplay())
+  sendCommand(TM16XX_CMD_DISPLAY | (active ? 8 : 0) | (intensity>7 ? 7 : intensity));
+  for(byte n=0; n<_nModules; n++)
+    _aModules[n]->levelSetup(active, intensity);    // keep track of the level, e.g. for fadeTo()
+}
+
+void TM16xxSharedBus::clearDisplay()
+{ // Clear the display memory of all chips (see TM16xx::clearDisplay()). When all chips have the same size,
+  // the data is sent to all chips at once. Otherwise each chip is cleared after a single data command.
+  if(!_nModules)
+    return;
+  bool fSameSize=true;
+  for(byte n=1; n<_nModules; n++)
+  {
+    if(_aModules[n]->_maxDisplays!=_aModules[0]->_maxDisplays || _aModules[n]->_maxSegments!=_aModules[0]->_maxSegments)
+      fSameSize=false;
+  }
+  sendCommand(TM16XX_CMD_DATA_AUTO);		// set auto increment addressing mode
+  if(fSameSize)
+  {
+    start();
+    sendClear(_aModules[0]);
+    stop();
+  }
+  else
+  {
+    for(byte n=0; n<_nModules; n++)
+    {
+      _aModules[n]->start();
+      sendClear(_aModules[n]);
+      _aModules[n]->stop();
+    }
+  }
+  for(byte n=0; n<_nModules; n++)
+    _aModules[n]->shadowCleared();
+}
+
+void TM16xxSharedBus::sendClear(TM16xx *pModule)
+{ // send the address followed by bulk-sending of the data to clear the display memory
+  pModule->send(TM16XX_CMD_ADDRESS);
+  for(byte nPos=0; nPos<pModule->_maxDisplays; nPos++)
+  {
+    pModule->send(0x00);
+    if(pModule->_maxSegments>8)
+      pModule->send(0x00);    // send second byte (applicable to TM1638 and TM1668)
+  }
+}
+
+void TM16xxSharedBus::setBuffered(bool fBuffered)
+{
+  if(!fBuffered)
+    flush();
+  for(byte n=0; n<_nModules; n++)
+    _aModules[n]->setBuffered(fBuffered);
+}
+
+void TM16xxSharedBus::flush()
+{
+  service(0, 0);
+}
+
+bool TM16xxSharedBus::service(byte nMaxBytes, uint16_t uMaxMicros)
+{ // Send the buffered data of the chips. The data command is sent to all chips at once, then the changed runs of each
+  // chip follow back-to-back. Like TM16xx::service() the amount of data per call can be limited. The limit applies to all
+  // chips together. The chip that was not finished in the previous call continues first. Returns true when all is sent.
+#if(TM16XX_OPT_SHADOWRAM)
+  if(!hasPendingData())
+    return(true);
+  uint32_t tStart=micros();
+  byte nSent=0;
+  sendCommand(TM16XX_CMD_DATA_AUTO);		// set auto increment addressing mode of all chips
+  for(byte n=0; n<_nModules; n++)
+  {
+    TM16xx *pModule=_aModules[_nServiceModule];
+    if(pModule->_uShadowDirty)
+    {
+      nSent=pModule->sendRuns(nSent, nMaxBytes, tStart, uMaxMicros);
+      if(pModule->_uShadowDirty)
+        break;    // limit reached, continue with this chip at the next call
+    }
+    _nServiceModule=(_nServiceModule+1)%_nModules;
+  }
+  return(!hasPendingData());
+#else
+  (void)nMaxBytes; (void)uMaxMicros;
+  return(true);
+#endif
+}
+
+bool TM16xxSharedBus::hasPendingData()
+{
+  for(byte n=0; n<_nModules; n++)
+  {
+    if(_aModules[n]->hasPendingData())
+      return(true);
+  }
+  return(false);
+}
+
+#if(TM16XX_OPT_BACKGROUND)
+bool TM16xxSharedBus::tick()
+{ // Background refresh of the chips one after the other. The chip that is halfway a run keeps the bus until the run ends.
+  // Returns true while there is data left to be sent.
+  for(byte n=0; n<_nModules; n++)
+  {
+    TM16xx *pModule=_aModules[_nTickModule];
+    if(pModule->_nTickState!=TM16XX_TICK_IDLE || pModule->_uShadowDirty)
+    {
+      pModule->tick();
+      return(true);
+    }
+    _nTickModule=(_nTickModule+1)%_nModules;
+  }
+  return(false);
+}
+#endif
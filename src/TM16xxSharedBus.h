@@ -0,0 +1,93 @@
+/*
+TM16xxSharedBus.h - Multiple 3-wire chips (e.g. TM1638, TM1628, TM1668) on a common DIO/CLK with individual STB lines.
+
+Each chip is still defined by its own object, specifying the shared data and clock pins and its own strobe pin.
+NOTE: the bus object doesn't own the DIO/CLK pins. The chip objects keep using their own (identical) pin settings and
+their constructors all initialize the shared pins the same way. The bus only coordinates the chips: it pulls several
+strobe lines low for broadcasted commands and lets the first chip drive DIO/CLK. All chips should therefore be
+specified using the same data and clock pins.
+The TM16xxSharedBus class combines those objects. Commands that are the same for all chips (e.g. the display control
+command to set the intensity, or the data command) are sent only once, by pulling all strobe lines low at the same time.
+The buffered display data of the chips is then sent back-to-back after a single data command.
+The modules share the background refresh: when the sketch uses one chip, tick() of the other chips waits as well.
+
+Usage example:
+    #include <TM1638.h>
+    #include <TM16xxSharedBus.h>
+
+    // four TM1638 chips, sharing DIO=8 and CLK=9, each having its own strobe pin
+    TM1638 module1(8, 9, 7), module2(8, 9, 6), module3(8, 9, 5), module4(8, 9, 4);
+    TM16xx *modules[]={&module1, &module2, &module3, &module4};
+    TM16xxSharedBus bus(modules, 4);
+
+    void setup()
+    {
+      bus.begin(true, 2);      // clear all displays at once, then set the display mode and intensity of each chip
+      bus.setBuffered(true);
+    }
+
+    void loop()
+    {
+      module1.setDisplayToDecNumber(millis(), 0);
+      module2.setDisplayToString("HELLO");
+      bus.flush();             // one data command, then the changes of each chip back-to-back
+    }
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#ifndef TM16XXSHAREDBUS_h
+#define TM16XXSHAREDBUS_h
+
+#include "TM16xx.h"
+
+#define TM16XX_SHAREDBUS_MAX 8       // max number of chips on one bus
+
+class TM16xxSharedBus : public TM16xxGroup
+{
+  public:
+    /** Specify the chips that share the data and clock pins. Each chip has its own strobe pin */
+    TM16xxSharedBus(TM16xx *aModules[], byte nModules);
+
+    /** Clear all displays using broadcasted commands, then set the display mode, activation and intensity of each chip */
+    void begin(bool activateDisplay=true, byte intensity=7);
+
+    /** Send the same command to all chips at once */
+    virtual void sendCommand(byte cmd);
+
+    /** Set activation and intensity of all chips using a single command */
+    virtual void setupDisplay(bool active, byte intensity);
+
+    /** Clear the display memory of all chips */
+    void clearDisplay();
+
+    /** Set buffered mode of all chips (requires TM16XX_OPT_SHADOWRAM) */
+    void setBuffered(bool fBuffered=true);
+
+    /** Send the buffered data of all chips after a single data command */
+    void flush();
+
+    /** Send part of the buffered data of the chips: at most nMaxBytes bytes or uMaxMicros us (0=no limit) in total */
+    bool service(byte nMaxBytes=TM16XX_SERVICE_BYTES, uint16_t uMaxMicros=0);
+    bool hasPendingData();
+
+#if(TM16XX_OPT_BACKGROUND)
+    /** Background refresh of all chips. Call this instead of tick() of the individual chips */
+    bool tick();
+#endif
+
+  protected:
+    void start();    // pull the strobe lines of all chips low
+    void stop();
+
+  private:
+    void sendClear(TM16xx *pModule);
+    TM16xx *_aModules[TM16XX_SHAREDBUS_MAX];
+    byte _nModules;
+    byte _nServiceModule=0;   // chip being updated by service()
+#if(TM16XX_OPT_BACKGROUND)
+    byte _nTickModule=0;      // chip being updated by tick()
+#endif
+};
+
+#endif
@@ -0,0 +1,71 @@
+/*
+TM16xxSprite.cpp - Column-major sprites for TM16xxMatrix, TM16xxMatrix16 and TM16xxMatrixGFX.
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#include "TM16xxSprite.h"
+
+TM16xxSprite::TM16xxSprite(const byte *pData, byte nWidth, byte nHeight, const byte *pMask, bool fProgmem)
+{
+  _pData=pData;
+  _pMask=pMask;
+  _nWidth=nWidth;
+  _nHeight=(nHeight>TM16XX_SPRITE_MAXROWS ? TM16XX_SPRITE_MAXROWS : nHeight);
+  _fProgmem=fProgmem;
+}
+
+uint16_t TM16xxSprite::readColumn(const byte *pData, byte nCol)
+{ // Sprites of more than 8 rows have two bytes per column, the first byte holds the top rows
+  if(_nHeight<=8)
+    return(_fProgmem ? pgm_read_byte(pData+nCol) : pData[nCol]);
+  pData+=nCol*2;
+  if(_fProgmem)
+    return(pgm_read_byte(pData) | (pgm_read_byte(pData+1)<<8));
+  return(pData[0] | (pData[1]<<8));
+}
+
+uint16_t TM16xxSprite::getMask(byte nCol)
+{
+  uint16_t uRows=(_nHeight>=16 ? 0xFFFF : bit(_nHeight)-1);
+  if(nCol>=_nWidth)
+    return(0);
+  if(!_pMask)
+    return(uRows);
+  return(readColumn(_pMask, nCol) & uRows);
+}
+
+uint16_t TM16xxSprite::getColumn(byte nCol)
+{
+  if(nCol>=_nWidth)
+    return(0);
+  return(readColumn(_pData, nCol) & getMask(nCol));
+}
+
+uint16_t TM16xxSprite::blitColumn(uint16_t uColumn, byte nCol, int16_t y, byte nMode)
+{ // Rows that are moved beyond row 15 are clipped. The caller clips to the number of rows of the display.
+  if(nCol>=_nWidth || y<=-16 || y>=16)
+    return(uColumn);
+  uint16_t uData=getColumn(nCol);
+  uint16_t uMask=getMask(nCol);
+  if(y<0)
+  {
+    uData>>=-y;
+    uMask>>=-y;
+  }
+  else
+  {
+    uData<<=y;
+    uMask<<=y;
+  }
+  switch(nMode)
+  {
+    case TM16XX_BLIT_COPY:
+      return((uColumn & ~uMask) | uData);
+    case TM16XX_BLIT_XOR:
+      return(uColumn ^ uData);
+    case TM16XX_BLIT_CLEAR:
+      return(uColumn & ~uData);
+  }
+  return(uColumn | uData);
+}
@@ -0,0 +1,68 @@
+/*
+TM16xxSprite.h - Column-major sprites for TM16xxMatrix, TM16xxMatrix16 and TM16xxMatrixGFX.
+
+A sprite uses the same format as the memory of an LED matrix: one byte per column, the least significant bit is the
+top row. Sprites of 9-16 rows use two bytes per column, the first byte holding rows 0-7. An optional mask in the same
+format marks the pixels that belong to the sprite, the other pixels are transparent.
+The blit() method of the matrix classes combines the sprite with the display contents, using one of these modes:
+    TM16XX_BLIT_OR      set the pixels of the sprite, its background is transparent
+    TM16XX_BLIT_COPY    copy the sprite, its background pixels (or the pixels within the mask) are cleared
+    TM16XX_BLIT_XOR     invert the display where the sprite has its pixels set, blit again to restore the display
+    TM16XX_BLIT_CLEAR   clear the display where the sprite has its pixels set, e.g. to erase the sprite
+The sprite is clipped to the display. Each column is combined using a few shifts and logic operations.
+
+Usage example:
+    #include <TM1640.h>
+    #include <TM16xxMatrix.h>
+    #include <TM16xxSprite.h>
+
+    const byte PROGMEM heartData[]={0x0C, 0x1E, 0x3C, 0x1E, 0x0C};   // 5 columns of 6 rows
+    TM16xxSprite heart(heartData, 5, 6);       // data in PROGMEM, use TM16xxSprite(data, 5, 6, NULL, false) for RAM
+
+    TM1640 module(9, 10);
+    TM16xxMatrix matrix(&module, 8, 8);
+    ...
+    matrix.blit(x, y, heart, TM16XX_BLIT_XOR);
+
+Part of the TM16xx library by Maxint. See https://github.com/maxint-rd/TM16xx
+*/
+
+#ifndef TM16XXSPRITE_h
+#define TM16XXSPRITE_h
+
+#include "TM16xx.h"
+
+#define TM16XX_BLIT_OR 0
+#define TM16XX_BLIT_COPY 1
+#define TM16XX_BLIT_XOR 2
+#define TM16XX_BLIT_CLEAR 3
+
+#define TM16XX_SPRITE_MAXROWS 16
+
+class TM16xxSprite
+{
+  public:
+    /** Specify the sprite data (and optional mask) of nWidth columns and nHeight rows (1-16). By default in PROGMEM */
+    TM16xxSprite(const byte *pData, byte nWidth, byte nHeight, const byte *pMask=NULL, bool fProgmem=true);
+    inline byte getWidth() { return(_nWidth); }
+    inline byte getHeight() { return(_nHeight); }
+
+    /** Pixels of column nCol, bit n is row n */
+    uint16_t getColumn(byte nCol);
+
+    /** Pixels of column nCol that are part of the sprite: the mask or all rows when there is no mask */
+    uint16_t getMask(byte nCol);
+
+    /** Combine column nCol of the sprite, moved down y rows (up when negative), with the display column uColumn */
+    uint16_t blitColumn(uint16_t uColumn, byte nCol, int16_t y, byte nMode);
+
+  private:
+    uint16_t readColumn(const byte *pData, byte nCol);
+    const byte *_pData;
+    const byte *_pMask;
+    byte _nWidth;
+    byte _nHeight;
+    bool _fProgmem;
+};
+
+#endif
@@ -45,6 +45,15 @@ Made by Maxint R&D. See https://github.com/maxint-rd
 #include "TMHT16K33.h"
 #include <Wire.h>       // needed for I2C
 
+// Maximum number of data bytes in one transaction, the Wire buffer also holds the address byte
+#if defined(BUFFER_LENGTH)
+  #define TMHT16K33_I2C_CHUNK (BUFFER_LENGTH-1)
+#elif defined(I2C_BUFFER_LENGTH)
+  #define TMHT16K33_I2C_CHUNK (I2C_BUFFER_LENGTH-1)
+#else
+  #define TMHT16K33_I2C_CHUNK 16
+#endif
+
 TMHT16K33::TMHT16K33(byte i2cAddress, byte sdaPin, byte sclPin, byte numDigits)
 	: TM16xx(sdaPin, sclPin, sdaPin, TMHT16K33_MAX_POS, numDigits)
 { // The HT16K33 has I2C using SDA and SCL on default address 0x70. In the parent-constructor DIN, CLK and STB are initialized, but not used.
@@ -89,7 +98,7 @@ void TMHT16K33::begin(bool activateDisplay, byte intensity)
 #else
   Wire.begin();
 #endif
-  Wire.setClock(100000L);     // NOTE: when setting a speed that's not supported 400k is used on ESP/LGT. Only 100k and 400k seem to be supported on LGT8F328P
+  Wire.setClock(_uI2cClock);     // NOTE: when setting a speed that's not supported 400k is used on ESP/LGT. Only 100k and 400k seem to be supported on LGT8F328P
 
   if(!isConnected())
   { // I2C connection failed!
@@ -101,6 +110,14 @@ void TMHT16K33::begin(bool activateDisplay, byte intensity)
   setupDisplay(activateDisplay, intensity);
 } 
   
+void TMHT16K33::setI2CClock(uint32_t uClock)
+{ // Set the I2C clock speed. Default is 100kHz. The HT16K33 supports up to 400kHz.
+  // Faster speeds reduce the time needed to refresh the display. Can be called before or after begin().
+  _uI2cClock=uClock;
+  if(fBeginDone)
+    Wire.setClock(_uI2cClock);
+}
+
 void TMHT16K33::start()
 { // For the TMHT16K33, start and stop are sent using I2C protocol so no separate start or stop
 }
@@ -117,23 +134,90 @@ void TMHT16K33::send(byte data)
   Wire.endTransmission();
 }
 
+void TMHT16K33::frameWrite(byte nIndex, byte data)
+{ // Update a byte in the framebuffer and extend the changed range. Unchanged data is skipped.
+  if(_btFrame[nIndex]==data)
+  {
+#if(TM16XX_OPT_SHADOWRAM)
+    _dwWritesSuppressed++;
+#endif
+    return;
+  }
+  _btFrame[nIndex]=data;
+  _nFrameDirtyFirst=__min(_nFrameDirtyFirst, nIndex);
+  _nFrameDirtyLast=__max(_nFrameDirtyLast, nIndex);
+}
+
 void TMHT16K33::sendData(byte address, byte data)
 {	// Note: HT16K33 uses different commands than TM16XX chips
+  // The data is written to the framebuffer, sendData() only sets segments 0-7 of the digit.
   begin();    // begin() is implicitly called upon first sending of display data, but only executed once.
-  Wire.beginTransmission(_i2cAddress);
-  Wire.write(TMHT16K33_CMD_ADDRESS | ((address&0x07)<<1));
-  Wire.write(data);
-  Wire.endTransmission();
+  frameWrite((address&0x07)<<1, data);
+#if(TM16XX_OPT_SHADOWRAM)
+  if(_fBuffered)
+    return;   // will be sent by flush()
+#endif
+  flush();
 }
 
 void TMHT16K33::sendData16(byte address, uint16_t data)
 {	// Note: HT16K33 uses different commands than TM16XX chips
   begin();    // begin() is implicitly called upon first sending of display data, but only executed once.
-  Wire.beginTransmission(_i2cAddress);
-  Wire.write(TMHT16K33_CMD_ADDRESS | ((address&0x07)<<1));
-  Wire.write(data&0x00FF);    // data address increments automaticaly, first write segments 0-7
-  Wire.write(data>>8);        // then write segments 8-15
-  Wire.endTransmission();
+  frameWrite((address&0x07)<<1, data&0x00FF);      // data address increments automaticaly, first write segments 0-7
+  frameWrite(((address&0x07)<<1)+1, data>>8);     // then write segments 8-15
+#if(TM16XX_OPT_SHADOWRAM)
+  if(_fBuffered)
+    return;   // will be sent by flush()
+#endif
+  flush();
+}
+
+void TMHT16K33::flush()
+{ // Send all changed data of the framebuffer
+  service(0, 0);
+}
+
+bool TMHT16K33::service(byte nMaxBytes, uint16_t uMaxMicros)
+{ // Send the changed range of the framebuffer using the auto-incremented address of the HT16K33.
+  // The range is sent in as few transactions as the Wire buffer allows. Like TM16xx::service() the amount of data
+  // per call can be limited, in which case sending continues at the next call. A digit (two bytes) is never split.
+  fadeStep();
+  if(_nFrameDirtyFirst>_nFrameDirtyLast)
+    return(true);
+  uint32_t tStart=micros();
+  byte nSent=0;
+  _nFrameDirtyFirst&=~1;    // send whole digits
+  _nFrameDirtyLast|=1;
+  while(_nFrameDirtyFirst<=_nFrameDirtyLast)
+  {
+    if(nSent && serviceSpent(nSent+2, nMaxBytes, tStart, uMaxMicros))
+      break;
+    byte nLength=__min(_nFrameDirtyLast-_nFrameDirtyFirst+1, TMHT16K33_I2C_CHUNK&~1);
+    if(nMaxBytes && nLength>nMaxBytes-nSent)
+      nLength=__max((nMaxBytes-nSent)&~1, 2);
+    Wire.beginTransmission(_i2cAddress);
+    Wire.write(TMHT16K33_CMD_ADDRESS | _nFrameDirtyFirst);
+    for(byte n=0; n<nLength; n++)
+      Wire.write(_btFrame[_nFrameDirtyFirst+n]);
+    Wire.endTransmission();
+    _nFrameDirtyFirst+=nLength;
+    nSent+=nLength;
+#if(TM16XX_OPT_SHADOWRAM)
+    _dwWritesPerformed+=nLength;
+#endif
+  }
+  if(_nFrameDirtyFirst>_nFrameDirtyLast)
+  { // all sent
+    _nFrameDirtyFirst=0xFF;
+    _nFrameDirtyLast=0;
+    return(true);
+  }
+  return(false);
+}
+
+bool TMHT16K33::hasPendingData()
+{
+  return(_nFrameDirtyFirst<=_nFrameDirtyLast);
 }
 
 void TMHT16K33::sendCommand(byte cmd)
@@ -145,9 +229,12 @@ void TMHT16K33::sendCommand(byte cmd)
 
 void TMHT16K33::clearDisplay()
 {	// Clear all data registers. The number of registers is 0x00 to 0x0F on HT16K33 for COM0-COM7 x SEG0-SEG15.
-	for (int i = 0; i < _maxDisplays; i++) {
-    sendData16(i, 0);
-  }
+  // All registers are sent at once using the auto-incremented address.
+  begin();    // begin() is implicitly called upon first sending of display data, but only executed once.
+  memset(_btFrame, 0, TMHT16K33_RAM_SIZE);
+  _nFrameDirtyFirst=0;
+  _nFrameDirtyLast=TMHT16K33_RAM_SIZE-1;
+  flush();
 }
 
 void TMHT16K33::setupDisplay(bool active, byte intensity)
@@ -156,6 +243,29 @@ void TMHT16K33::setupDisplay(bool active, byte intensity)
   sendCommand(active ? TMHT16K33_ON : TMHT16K33_STANDBY);
   sendCommand(active ? TMHT16K33_DISPLAYON : TMHT16K33_DISPLAYOFF);
   sendCommand(TMHT16K33_BRIGHTNESS | (((intensity&0x07)<<1)|0x01));
+  levelSetup(active, intensity&0x07);
+}
+
+byte TMHT16K33::getLevels()
+{ // The HT16K33 has 16 levels of duty cycle
+  return(16);
+}
+
+void TMHT16K33::setLevel(byte nLevel)
+{ // Set one of the 16 duty cycle levels. Only the display is switched off at level 0, so the oscillator keeps running.
+  nLevel=min(nLevel, 16);
+  if(!nLevel)
+    sendCommand(TMHT16K33_DISPLAYOFF);
+  else
+  {
+    if(!_nLevel)
+    {
+      sendCommand(TMHT16K33_ON);
+      sendCommand(TMHT16K33_DISPLAYON);
+    }
+    sendCommand(TMHT16K33_BRIGHTNESS | (nLevel-1));
+  }
+  _nLevel=nLevel;
 }
 
 